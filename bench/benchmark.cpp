@@ -0,0 +1,31 @@
+#include "benchmark.hpp"
+#include <vector>
+#include <logging.hpp>
+
+#include <stdint.h>
+#include <memory>
+
+MARTIN_BENCHMARK_INCLUDES
+
+namespace Martin {
+    std::vector<std::shared_ptr<Benchmark>> benchmarks;
+
+#define BENCHMARK_VECTOR benchmarks
+
+    void Init() {
+MARTIN_BENCHMARK_INITS
+    }
+}
+
+int main() {
+    Martin::Init();
+
+    Martin::Print("Found $ benchmarks.\n", Martin::benchmarks.size());
+
+    for (auto benchmark : Martin::benchmarks) {
+        Martin::Print("Running benchmark '$'\n", benchmark->GetName());
+        benchmark->RunBenchmark();
+    }
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef MARTIN_BENCHMARK
+#define MARTIN_BENCHMARK
+
+#include <string>
+#include <chrono>
+
+namespace Martin {
+    class Benchmark {
+    public:
+        virtual ~Benchmark() {}
+        virtual std::string GetName() const { return "Generic"; }
+        virtual void RunBenchmark() {}
+
+    protected:
+        // Runs func the given number of times and returns the fastest run in seconds
+        template <typename F>
+        static double TimeBest(F func, unsigned int runs = 3) {
+            double best = 0.0;
+
+            for (unsigned int i = 0; i < runs; i++) {
+                auto start = std::chrono::steady_clock::now();
+                func();
+                auto stop = std::chrono::steady_clock::now();
+
+                double seconds = std::chrono::duration<double>(stop - start).count();
+                if ((i == 0) || (seconds < best))
+                    best = seconds;
+            }
+
+            return best;
+        }
+    };
+}
+
+#endif
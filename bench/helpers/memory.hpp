@@ -0,0 +1,87 @@
+#ifndef MARTIN_BENCH_HELPERS_MEMORY
+#define MARTIN_BENCH_HELPERS_MEMORY
+
+#include <platform.hpp>
+
+#include <string>
+#include <fstream>
+#include <stddef.h>
+
+#ifdef unix
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace Martin {
+
+    // A field of /proc/self/status in bytes, 0 when there is none
+    inline size_t ReadProcessStatus(const std::string& field) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line)) {
+            if (line.compare(0, field.length() + 1, field + ":") == 0)
+                return std::stoull(line.substr(field.length() + 1)) * 1024;
+        }
+
+        return 0;
+    }
+
+    // Runs func in a child process and returns how far its resident memory
+    // peaked above where it stood before func, in bytes. Anything func builds
+    // itself counts, so pass it sizes rather than prebuilt inputs. Returns 0
+    // where the peak can't be read, which is anywhere but Linux
+    template <typename F>
+    size_t MeasurePeakMemory(F func) {
+#ifdef unix
+        int fds[2];
+        if (pipe(fds) != 0)
+            return 0;
+
+        pid_t child = fork();
+        if (child == 0) {
+            close(fds[0]);
+
+#ifdef __GLIBC__
+            // Freed memory the benchmarks before left resident would otherwise
+            // be reused without showing up as growth
+            malloc_trim(0);
+#endif
+
+            // Resets the peak to the current resident size
+            std::ofstream("/proc/self/clear_refs") << "5";
+            size_t start = ReadProcessStatus("VmRSS");
+
+            func();
+
+            size_t peak = ReadProcessStatus("VmHWM");
+            size_t growth = (peak > start) ? peak - start : 0;
+
+            ssize_t written = write(fds[1], &growth, sizeof(growth));
+            _exit(written == sizeof(growth) ? 0 : 1);
+        }
+
+        close(fds[1]);
+
+        size_t growth = 0;
+        if ((child < 0) || (read(fds[0], &growth, sizeof(growth)) != sizeof(growth)))
+            growth = 0;
+
+        close(fds[0]);
+        if (child > 0)
+            waitpid(child, nullptr, 0);
+
+        return growth;
+#else
+        func();
+        return 0;
+#endif
+    }
+
+}
+
+#endif
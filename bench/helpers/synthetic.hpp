@@ -0,0 +1,34 @@
+#ifndef MARTIN_BENCH_HELPERS_SYNTHETIC
+#define MARTIN_BENCH_HELPERS_SYNTHETIC
+
+#include <string>
+
+namespace Martin {
+
+    // Builds a module made of `functions` small functions that exercise
+    // comments, literals, operators and nested enclosures
+    inline std::string GenerateModule(size_t functions) {
+        std::string module;
+
+        for (size_t i = 0; i < functions; i++) {
+            std::string n = std::to_string(i);
+
+            module += "// Generated function " + n + "\n";
+            module += "func add_" + n + "(let nums : array[-1] Int32) -> Int32 {\n";
+            module += "    let total : Int32 = 0\n";
+            module += "    for (let i := 0, i < nums.count(), i += 1) {\n";
+            module += "        total += nums.get(i) * 3 + 0x1F - 2.5\n";
+            module += "    }\n";
+            module += "    /* Block comment\n";
+            module += "       spanning lines */\n";
+            module += "    let name : String = \"value " + n + "\\n\"\n";
+            module += "    return total\n";
+            module += "}\n\n";
+        }
+
+        return module;
+    }
+
+}
+
+#endif
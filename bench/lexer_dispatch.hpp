@@ -0,0 +1,38 @@
+#ifndef MARTIN_BENCH_LEXER_DISPATCH
+#define MARTIN_BENCH_LEXER_DISPATCH
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_dispatch : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Dispatch)";
+        }
+
+        void RunBenchmark() override {
+            std::string source = GenerateModule(8000);
+
+            Run("Pattern chain", Tokenizer::Matching::PatternChain, source);
+            Run("Dispatch table", Tokenizer::Matching::DispatchTable, source);
+        }
+
+    private:
+        void Run(const std::string& name, Tokenizer::Matching matching, const std::string& source) {
+            Tokenizer tokenizer(matching);
+            size_t tokens = 0;
+
+            double seconds = TimeBest([&]() {
+                tokens = tokenizer.TokenizeString(source)->size();
+            });
+
+            Print("    $: $ tokens in $ s, $ tokens/s\n", name, tokens, std::to_string(seconds), std::to_string(tokens / seconds));
+        }
+    };
+}
+
+#endif
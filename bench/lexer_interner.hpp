@@ -0,0 +1,58 @@
+#ifndef MARTIN_BENCH_LEXER_INTERNER
+#define MARTIN_BENCH_LEXER_INTERNER
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <sourcebuffer.hpp>
+#include <interner.hpp>
+#include <logging.hpp>
+
+#include <filesystem>
+
+namespace Martin {
+    class Benchmark_lexer_interner : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Interner)";
+        }
+
+        void RunBenchmark() override {
+            size_t files = 0;
+
+            // Our own sources when run from the repository, then a generated module
+            if (std::filesystem::is_directory("examples/src")) {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator("examples/src")) {
+                    if (entry.path().extension() != ".martin")
+                        continue;
+
+                    std::string error;
+                    auto source = SourceBufferBase::FromFile(entry.path().string(), error);
+
+                    if (source) {
+                        TokenizerSingleton.TokenizeBuffer(source);
+                        files++;
+                    }
+                }
+
+                Report(Format("After examples ($ files)", files));
+            }
+
+            TokenizerSingleton.TokenizeBuffer(GenerateModule(8000));
+            Report("After a synthetic module");
+        }
+
+    private:
+        // Totals for everything interned so far in this process
+        static void Report(const std::string& name) {
+            Interner::Stats stats = InternerSingleton.GetStats();
+            double ratio = stats.bytes_stored ? (double)stats.bytes_interned / stats.bytes_stored : 0.0;
+
+            Print("    $: $ spellings, $ unique, $ bytes lexed, $ bytes stored, x$ deduplication\n", name, stats.interned, stats.unique, stats.bytes_interned, stats.bytes_stored, std::to_string(ratio));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef MARTIN_BENCH_LEXER_LITERALS
+#define MARTIN_BENCH_LEXER_LITERALS
+
+#include "benchmark.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_literals : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Literals)";
+        }
+
+        void RunBenchmark() override {
+            // An embedded data table, where literals are only ever validated
+            std::string source = "let table : array[-1] Float64 = [\n";
+            for (size_t i = 0; i < 200000; i++)
+                source += "    " + std::to_string(i) + ".125, 0x" + std::to_string(i % 8) + "F, \"row " + std::to_string(i) + "\\n\", -" + std::to_string(i) + ",\n";
+            source += "]\n";
+
+            size_t tokens = 0;
+
+            double lazy = TimeBest([&]() {
+                tokens = TokenizerSingleton.TokenizeBuffer(source)->Size();
+            });
+
+            double decoded = TimeBest([&]() {
+                auto buffer = TokenizerSingleton.TokenizeBuffer(source);
+
+                for (size_t i = 0; i < buffer->Size(); i++) {
+                    switch (buffer->GetType(i)) {
+                        case TokenType::Type::FloatingDouble:
+                        case TokenType::Type::UInteger:
+                        case TokenType::Type::Integer:
+                            buffer->GetValue(i);
+                            break;
+
+                        case TokenType::Type::String8:
+                            buffer->GetBytes(i);
+                            break;
+
+                        default:
+                            break;
+                    }
+                }
+            });
+
+            Print("    Lexing only: $ tokens in $ s\n", tokens, std::to_string(lazy));
+            Print("    Lexing and decoding every literal: $ tokens in $ s\n", tokens, std::to_string(decoded));
+        }
+    };
+}
+
+#endif
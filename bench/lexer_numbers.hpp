@@ -0,0 +1,72 @@
+#ifndef MARTIN_BENCH_LEXER_NUMBERS
+#define MARTIN_BENCH_LEXER_NUMBERS
+
+#include "benchmark.hpp"
+
+#include <numbers.hpp>
+#include <logging.hpp>
+
+#include <vector>
+
+namespace Martin {
+    class Benchmark_lexer_numbers : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Numbers)";
+        }
+
+        void RunBenchmark() override {
+            const std::pair<unsigned int, const char*> radixes[] = {
+                { 2, "Binary" }, { 8, "Octal" }, { 10, "Decimal" }, { 16, "Hexadecimal" }
+            };
+
+            for (auto& [radix, name] : radixes) {
+                // Literals of every length that fits, mostly long ones like masks and table data
+                std::vector<std::string> literals;
+                uintmax_t seed = 0x9E3779B97F4A7C15;
+
+                for (size_t i = 0; i < 500000; i++) {
+                    seed = seed * 6364136223846793005 + 1442695040888963407;
+
+                    std::string text;
+                    for (uintmax_t value = seed >> (i % 48); value; value /= radix)
+                        text.insert(text.begin(), "0123456789ABCDEF"[value % radix]);
+
+                    literals.push_back(text);
+                }
+
+                // Keeps the loops from being optimized away
+                volatile uintmax_t sink = 0;
+
+                double swar = TimeBest([&]() {
+                    for (auto& literal : literals) {
+                        uintmax_t value = 0;
+                        Numbers::ParseUnsigned(literal, radix, value);
+                        sink = value;
+                    }
+                });
+
+                // Validating and checking for overflow one digit at a time
+                double scalar = TimeBest([&]() {
+                    for (auto& literal : literals) {
+                        uintmax_t value = 0;
+
+                        for (char c : literal) {
+                            unsigned int digit = ((c >= '0') && (c <= '9')) ? (c - '0') : ((c >= 'A') && (c <= 'F')) ? (c - 'A' + 10) : radix;
+                            if ((digit >= radix) || (value > (UINTMAX_MAX - digit) / radix))
+                                break;
+
+                            value = value * radix + digit;
+                        }
+
+                        sink = value;
+                    }
+                });
+
+                Print("    $: $ s eight digits at a time, $ s one at a time\n", name, std::to_string(swar), std::to_string(scalar));
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef MARTIN_BENCH_LEXER_PARALLEL
+#define MARTIN_BENCH_LEXER_PARALLEL
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <sourcebuffer.hpp>
+#include <parallel.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_parallel : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Parallel)";
+        }
+
+        void RunBenchmark() override {
+            // Roughly 100 MB of source
+            auto source = SourceBufferBase::FromString(GenerateModule(300000));
+            double megabytes = source->GetSize() / (1024.0 * 1024.0);
+            double serial = 0;
+
+            size_t cores = GetDefaultThreadCount();
+
+            // Powers of two up to every core
+            for (size_t threads = 1; threads <= cores; threads = (threads * 2 > cores && threads < cores) ? cores : threads * 2) {
+                size_t tokens = 0;
+
+                double seconds = TimeBest([&]() {
+                    tokens = TokenizerSingleton.TokenizeParallel(source, threads)->Size();
+                }, 1);
+
+                if (threads == 1)
+                    serial = seconds;
+
+                Print("    $ threads: $ MB, $ tokens in $ s, $ MB/s, x$ vs 1 thread\n", threads, std::to_string(megabytes), tokens, std::to_string(seconds), std::to_string(megabytes / seconds), std::to_string(serial / seconds));
+            }
+        }
+    };
+}
+
+#endif
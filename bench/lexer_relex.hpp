@@ -0,0 +1,43 @@
+#ifndef MARTIN_BENCH_LEXER_RELEX
+#define MARTIN_BENCH_LEXER_RELEX
+
+#include "benchmark.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_relex : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Relex)";
+        }
+
+        void RunBenchmark() override {
+            std::string code;
+            for (size_t i = 0; code.length() < (1 << 22); i++)
+                code += "func f" + std::to_string(i) + "(x : Int32) -> Int32 { return x * " + std::to_string(i) + " + 0x1F } // \"entry\"\n";
+
+            auto buffer = TokenizerSingleton.TokenizeBuffer(code);
+            size_t offset = code.length() / 2;
+
+            double full = TimeBest([&]() {
+                std::string edited = code;
+                edited.insert(offset, "y");
+                TokenizerSingleton.TokenizeBuffer(edited);
+            });
+
+            // A keystroke in the middle of the file
+            double relex = TimeBest([&]() {
+                TokenizerSingleton.Relex(buffer, offset, 0, "y");
+            });
+
+            Print("    $ tokens, $ MB\n", buffer->Size(), code.length() >> 20);
+            Print("    Lexing the edited file again: $ s\n", std::to_string(full));
+            Print("    Relexing around the edit: $ s\n", std::to_string(relex));
+        }
+    };
+}
+
+#endif
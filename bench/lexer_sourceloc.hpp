@@ -0,0 +1,42 @@
+#ifndef MARTIN_BENCH_LEXER_SOURCELOC
+#define MARTIN_BENCH_LEXER_SOURCELOC
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <sourcebuffer.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_sourceloc : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(SourceLoc)";
+        }
+
+        void RunBenchmark() override {
+            std::string code = GenerateModule(8000);
+            auto buffer = TokenizerSingleton.TokenizeBuffer(code);
+            size_t lines = 0;
+
+            // A fresh source every run, so the line table gets built each time
+            double table_seconds = TimeBest([&]() {
+                auto source = SourceBufferBase::FromString(code);
+                lines = source->GetLine(code.size() - 1);
+            });
+
+            size_t checksum = 0;
+            double lookup_seconds = TimeBest([&]() {
+                for (size_t i = 0; i < buffer->Size(); i++)
+                    checksum += buffer->GetLineNumber(i) + buffer->GetColumn(i);
+            });
+
+            Print("    Line table: $ lines of $ bytes in $ s\n", lines, code.size(), std::to_string(table_seconds));
+            Print("    Line and column of $ tokens in $ s (checksum $)\n", buffer->Size(), std::to_string(lookup_seconds), checksum);
+        }
+    };
+}
+
+#endif
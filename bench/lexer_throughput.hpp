@@ -0,0 +1,41 @@
+#ifndef MARTIN_BENCH_LEXER_THROUGHPUT
+#define MARTIN_BENCH_LEXER_THROUGHPUT
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_throughput : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Throughput)";
+        }
+
+        void RunBenchmark() override {
+            double last = 0.0;
+
+            // Doubles the input each step, a linear lexer keeps the ratio near 2
+            for (size_t functions = 1000; functions <= 16000; functions *= 2) {
+                std::string source = GenerateModule(functions);
+                size_t tokens = 0;
+
+                double seconds = TimeBest([&]() {
+                    tokens = TokenizerSingleton.TokenizeString(source)->size();
+                });
+
+                double mb = source.size() / (1024.0 * 1024.0);
+                std::string ratio = (last > 0.0) ? std::to_string(seconds / last) : std::string("-");
+
+                Print("    $ bytes, $ tokens: $ s, $ MB/s, x$ vs previous\n",
+                    source.size(), tokens, std::to_string(seconds), std::to_string(mb / seconds), ratio);
+
+                last = seconds;
+            }
+        }
+    };
+}
+
+#endif
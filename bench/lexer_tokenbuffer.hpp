@@ -0,0 +1,36 @@
+#ifndef MARTIN_BENCH_LEXER_TOKENBUFFER
+#define MARTIN_BENCH_LEXER_TOKENBUFFER
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_lexer_tokenbuffer : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(TokenBuffer)";
+        }
+
+        void RunBenchmark() override {
+            std::string source = GenerateModule(8000);
+            size_t tokens = 0;
+
+            double buffer_seconds = TimeBest([&]() {
+                tokens = TokenizerSingleton.TokenizeBuffer(source)->Size();
+            });
+
+            double list_seconds = TimeBest([&]() {
+                tokens = TokenizerSingleton.TokenizeString(source)->size();
+            });
+
+            Print("    TokenBuffer: $ tokens in $ s, $ bytes of records\n", tokens, std::to_string(buffer_seconds), tokens * sizeof(TokenRecord));
+            Print("    TokenList views: $ tokens in $ s\n", tokens, std::to_string(list_seconds));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef MARTIN_BENCH_LEXER_TOKENCACHE
+#define MARTIN_BENCH_LEXER_TOKENCACHE
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <tokencache.hpp>
+#include <sourcebuffer.hpp>
+#include <logging.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace Martin {
+    class Benchmark_lexer_tokencache : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(TokenCache)";
+        }
+
+        void RunBenchmark() override {
+            std::filesystem::path root = std::filesystem::temp_directory_path() / "martin-bench-tokencache";
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root / "src");
+
+            // A project of 2000 files of 20 functions each
+            std::vector<std::string> paths;
+            size_t bytes = 0;
+
+            for (size_t i = 0; i < 2000; i++) {
+                std::string path = (root / "src" / ("file" + std::to_string(i) + ".martin")).string();
+                std::string module = "let file_id : Int32 = " + std::to_string(i) + "\n" + GenerateModule(20);
+
+                std::ofstream(path, std::ios::binary) << module;
+                paths.push_back(path);
+                bytes += module.length();
+            }
+
+            auto run = [&](TokenCache* cache) {
+                size_t tokens = 0;
+                std::string error;
+
+                for (auto& path : paths) {
+                    SourceBuffer source = SourceBufferBase::FromFile(path, error);
+                    tokens += (cache ? cache->Tokenize(source) : TokenizerSingleton.TokenizeBuffer(source))->Size();
+                }
+
+                return tokens;
+            };
+
+            size_t tokens = 0;
+            double uncached = TimeBest([&]() { tokens = run(nullptr); });
+
+            std::string directory = (root / "cache").string();
+            double cold = TimeBest([&]() {
+                std::filesystem::remove_all(directory);
+                TokenCache cache(directory);
+                run(&cache);
+            });
+
+            TokenCache cache(directory);
+            double warm = TimeBest([&]() { run(&cache); });
+
+            Print("    $ files, $ bytes, $ tokens\n", paths.size(), bytes, tokens);
+            Print("    No cache: $ s\n", std::to_string(uncached));
+            Print("    Cold cache: $ s\n", std::to_string(cold));
+            Print("    Warm cache: $ s\n", std::to_string(warm));
+
+            std::filesystem::remove_all(root);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef MARTIN_BENCH_LEXER_TOKENSTREAM
+#define MARTIN_BENCH_LEXER_TOKENSTREAM
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+#include "helpers/memory.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <tokenstream.hpp>
+#include <parse.hpp>
+#include <logging.hpp>
+
+#include <cstdlib>
+
+namespace Martin {
+    class Benchmark_lexer_tokenstream : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Lexer(TokenStream)";
+        }
+
+        void RunBenchmark() override {
+            // MARTIN_BENCH_STREAM_MB raises the input into the hundreds of MB,
+            // reading the whole token list of those needs several GB
+            size_t megabytes = 64;
+            if (const char* env = std::getenv("MARTIN_BENCH_STREAM_MB"))
+                megabytes = std::strtoull(env, nullptr, 10);
+
+            size_t functions = (megabytes << 20) / 310;
+
+            // Counting identifiers, which needs no token after it has been read
+            size_t listed = MeasurePeakMemory([&]() {
+                std::string source = GenerateModule(functions);
+                size_t identifiers = 0;
+
+                TokenList tokens = TokenizerSingleton.TokenizeString(source);
+                for (auto& token : *tokens)
+                    identifiers += token->GetType() == TokenType::Type::Identifier;
+            });
+
+            // Interned spellings stay around in both, the stream's other memory is bounded
+            size_t streamed = MeasurePeakMemory([&]() {
+                std::string source = GenerateModule(functions);
+                size_t identifiers = 0;
+
+                TokenStream stream = TokenStream(new TokenStreamBase(SourceBufferBase::FromString(source)));
+                while (Token token = stream->Next())
+                    identifiers += token->GetType() == TokenType::Type::Identifier;
+            });
+
+            // The source itself takes the same in both
+            size_t source = MeasurePeakMemory([&]() {
+                SourceBufferBase::FromString(GenerateModule(functions));
+            });
+
+            Print("    Reading every token of $ MB, source alone peaks $ MB above the start\n", megabytes, source >> 20);
+            if (listed)
+                Print("    Token list: $ MB peak\n", listed >> 20);
+            else
+                Print("    Token list: no result, likely out of memory\n");
+            Print("    Token stream: $ MB peak\n", streamed >> 20);
+
+            // The generators go over the whole tree many times, so the parser
+            // keeps every token however they arrive
+            size_t parsed_functions = 2000;
+
+            size_t parsed = MeasurePeakMemory([&]() {
+                std::string error;
+                ParserSingleton.ParseString(GenerateModule(parsed_functions), error);
+            });
+
+            size_t parsed_streamed = MeasurePeakMemory([&]() {
+                std::string source = GenerateModule(parsed_functions);
+                ParserSingleton.ParseTokens(TokenStream(new TokenStreamBase(SourceBufferBase::FromString(source))));
+            });
+
+            double seconds = TimeBest([&]() {
+                std::string error;
+                ParserSingleton.ParseString(GenerateModule(parsed_functions), error);
+            }, 1);
+
+            double pipelined = TimeBest([&]() {
+                std::string source = GenerateModule(parsed_functions);
+                ParserSingleton.ParseTokens(TokenStream(new TokenStreamBase(SourceBufferBase::FromString(source))));
+            }, 1);
+
+            Print("    Parsing $ functions from a token list: $ KB peak, $ s\n", parsed_functions, parsed >> 10, std::to_string(seconds));
+            Print("    Parsing $ functions from a token stream: $ KB peak, $ s\n", parsed_functions, parsed_streamed >> 10, std::to_string(pipelined));
+        }
+    };
+}
+
+#endif
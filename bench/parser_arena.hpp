@@ -0,0 +1,53 @@
+#ifndef MARTIN_BENCH_PARSER_ARENA
+#define MARTIN_BENCH_PARSER_ARENA
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <arena.hpp>
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_arena : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Arena)";
+        }
+
+        void RunBenchmark() override {
+            std::string module = GenerateModule(3000);
+            std::string error;
+
+            AstArena::Stats stats;
+            {
+                AstArena arena;
+                AstArena::Scope scope(&arena);
+                ParserSingleton.ParseString(module, error);
+                stats = arena.GetStats();
+            }
+
+            double parse_seconds = TimeBest([&]() {
+                ParserSingleton.ParseString(module, error);
+            });
+
+            double teardown_seconds = 0.0;
+            for (size_t i = 0; i < 3; i++) {
+                Tree tree = ParserSingleton.ParseString(module, error);
+
+                double seconds = TimeBest([&]() {
+                    tree = nullptr;
+                }, 1);
+
+                if ((i == 0) || (seconds < teardown_seconds))
+                    teardown_seconds = seconds;
+            }
+
+            // Each node used to be an allocation of its own plus one for its control block
+            Print("    $ nodes, $ bytes in $ allocations instead of $\n", stats.objects, stats.bytes, stats.blocks, stats.objects * 2);
+            Print("    Parse of $ bytes in $ s, teardown in $ s\n", module.size(), std::to_string(parse_seconds), std::to_string(teardown_seconds));
+        }
+    };
+}
+
+#endif
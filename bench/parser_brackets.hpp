@@ -0,0 +1,44 @@
+#ifndef MARTIN_BENCH_PARSER_BRACKETS
+#define MARTIN_BENCH_PARSER_BRACKETS
+
+#include "benchmark.hpp"
+
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_brackets : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Brackets)";
+        }
+
+        void RunBenchmark() override {
+            std::string error;
+
+            for (size_t depth : { 500, 1000, 2000 }) {
+                std::string code;
+                for (size_t i = 0; i < 20; i++)
+                    code += std::string(depth, '(') + "a + b" + std::string(depth, ')') + "\n";
+
+                double seconds = TimeBest([&]() {
+                    ParserSingleton.ParseString(code, error);
+                });
+
+                Print("    20 expressions nested $ deep in $ s\n", depth, std::to_string(seconds));
+            }
+
+            std::string code;
+            for (size_t i = 0; i < 5000; i++)
+                code += "f(a, [b, c], { d })\n";
+
+            double seconds = TimeBest([&]() {
+                ParserSingleton.ParseString(code, error);
+            });
+
+            Print("    5000 shallow calls in $ s\n", std::to_string(seconds));
+        }
+    };
+}
+
+#endif
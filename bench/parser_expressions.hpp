@@ -0,0 +1,97 @@
+#ifndef MARTIN_BENCH_PARSER_EXPRESSIONS
+#define MARTIN_BENCH_PARSER_EXPRESSIONS
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <tokens.hpp>
+#include <parse.hpp>
+#include <logging.hpp>
+#include <generators/expressions.hpp>
+
+namespace Martin {
+    class Benchmark_parser_expressions : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Expressions)";
+        }
+
+        void RunBenchmark() override {
+            std::string code;
+            for (size_t i = 0; i < 2000; i++) {
+                std::string n = std::to_string(i);
+                code += "a" + n + " * b + c ** 2 - d / e & f << g == h and not k or m\n";
+            }
+
+            TokenList tokens = TokenizerSingleton.TokenizeString(code);
+            size_t nodes = 0;
+
+            double sweep_seconds = TimeBest([&]() {
+                Tree tree = CreateTree(tokens);
+                Sweep(tree);
+                nodes = tokens->size() - tree->size();
+            });
+
+            double walk_seconds = TimeBest([&]() {
+                Tree tree = CreateTree(tokens);
+                OPExpressionsTreeGenerator generator;
+                ParseSession session(ParserSingleton);
+                generator.ProcessRange(session, tree, 0, tree->size());
+                nodes = tokens->size() - tree->size();
+            });
+
+            std::string module = GenerateModule(300);
+            std::string error;
+            double parse_seconds = TimeBest([&]() {
+                ParserSingleton.ParseString(module, error);
+            });
+
+            Print("    Sweeps: $ tokens in $ s, $ nodes/s\n", tokens->size(), std::to_string(sweep_seconds), std::to_string(nodes / sweep_seconds));
+            Print("    Single walk: $ tokens in $ s, $ nodes/s\n", tokens->size(), std::to_string(walk_seconds), std::to_string(nodes / walk_seconds));
+            Print("    Full parse of $ bytes in $ s\n", module.size(), std::to_string(parse_seconds));
+        }
+
+    private:
+        static Tree CreateTree(TokenList tokens) {
+            Tree tree = Tree(new TreeBase);
+            tree->reserve(tokens->size());
+
+            for (auto tk : *tokens) {
+                TokenNode token_node = TokenNode(new TokenNodeBase);
+                token_node->token = tk;
+                token_node->is_token = true;
+                tree->push_back(token_node);
+            }
+
+            return tree;
+        }
+
+        // One ParseBranch sweep per generator the walk replaces
+        static void Sweep(Tree tree) {
+            TreeGenerator generators[] = {
+                TreeGenerator(new OPMulDivModTreeGenerator),
+                TreeGenerator(new OPPowTreeGenerator),
+                TreeGenerator(new OPAddSubTreeGenerator),
+                TreeGenerator(new OPBitwiseTreeGenerator),
+                TreeGenerator(new OPEqualityTreeGenerator),
+                TreeGenerator(new OPNotLogicTreeGenerator),
+                TreeGenerator(new OPLogicalsTreeGenerator)
+            };
+
+            ParseSession session(ParserSingleton);
+            size_t end = tree->size();
+            for (auto gen : generators) {
+                size_t index = 0;
+                while ((index < end) && (index < tree->size())) {
+                    size_t removed = gen->ProcessBranch(session, tree, index, end);
+                    if (removed)
+                        end -= removed - 1;
+                    else
+                        index++;
+                }
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef MARTIN_BENCH_PARSER_FLATTREE
+#define MARTIN_BENCH_PARSER_FLATTREE
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <flattree.hpp>
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_flattree : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(FlatTree)";
+        }
+
+        void RunBenchmark() override {
+            std::string module = GenerateModule(1000);
+            std::string error;
+
+            Tree tree = ParserSingleton.ParseString(module, error);
+            FlatTree flat;
+
+            double flatten_seconds = TimeBest([&]() {
+                flat = FlatTree(new FlatTreeBase(tree));
+            });
+
+            // Every node type looked up once, the way lambda extraction looks
+            // up one of them
+            size_t found = 0;
+            double index_seconds = TimeBest([&]() {
+                found = 0;
+                for (size_t type = 0; type < TreeNodeBase::TypeCount; type++)
+                    found += Parser::GetAllNodesOfType(tree, (TreeNodeBase::Type)type).size();
+            });
+
+            NodeIndex index = tree->GetIndex();
+            tree->SetIndex(nullptr);
+
+            double tree_seconds = TimeBest([&]() {
+                found = 0;
+                for (size_t type = 0; type < TreeNodeBase::TypeCount; type++)
+                    found += Parser::GetAllNodesOfType(tree, (TreeNodeBase::Type)type).size();
+            });
+
+            double flat_seconds = TimeBest([&]() {
+                found = 0;
+                for (size_t type = 0; type < TreeNodeBase::TypeCount; type++)
+                    found += flat->FindAll((TreeNodeBase::Type)type).size();
+            });
+
+            Print("    Flattened $ items in $ s\n", flat->size(), std::to_string(flatten_seconds));
+            tree->SetIndex(index);
+
+            Print("    $ lookups by type finding $ nodes: $ s on nodes, $ s on the flat tree, $ s in the node index\n", TreeNodeBase::TypeCount, found, std::to_string(tree_seconds), std::to_string(flat_seconds), std::to_string(index_seconds));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef MARTIN_BENCH_PARSER_PARALLEL
+#define MARTIN_BENCH_PARSER_PARALLEL
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <parse.hpp>
+#include <tokens.hpp>
+#include <parallel.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_parallel : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Parallel)";
+        }
+
+        void RunBenchmark() override {
+            TokenList tokens = TokenizerSingleton.TokenizeString(GenerateModule(20000));
+            double serial = 0;
+
+            size_t cores = GetDefaultThreadCount();
+
+            // Powers of two up to every core
+            for (size_t threads = 1; threads <= cores; threads = (threads * 2 > cores && threads < cores) ? cores : threads * 2) {
+                size_t items = 0;
+
+                double seconds = TimeBest([&]() {
+                    items = ParserSingleton.ParseParallel(tokens, threads)->size();
+                }, 1);
+
+                if (threads == 1)
+                    serial = seconds;
+
+                Print("    $ threads: $ tokens, $ declarations in $ s, x$ vs 1 thread\n", threads, tokens->size(), items, std::to_string(seconds), std::to_string(serial / seconds));
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MARTIN_BENCH_PARSER_REDUCTIONS
+#define MARTIN_BENCH_PARSER_REDUCTIONS
+
+#include "benchmark.hpp"
+
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_reductions : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Reductions)";
+        }
+
+        void RunBenchmark() override {
+            // Flat top level statements, time per statement should stay flat
+            for (size_t count : { 10000, 30000, 100000 }) {
+                std::string code;
+                for (size_t i = 0; i < count; i++)
+                    code += "let v" + std::to_string(i) + " : Int32 = a + b * 3\n";
+
+                std::string error;
+                double seconds = TimeBest([&]() {
+                    ParserSingleton.ParseString(code, error);
+                }, 1);
+
+                Print("    $ statements in $ s, $ us per statement\n", count, std::to_string(seconds), std::to_string(seconds * 1e6 / count));
+            }
+        }
+    };
+}
+
+#endif
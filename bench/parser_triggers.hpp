@@ -0,0 +1,37 @@
+#ifndef MARTIN_BENCH_PARSER_TRIGGERS
+#define MARTIN_BENCH_PARSER_TRIGGERS
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_triggers : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Triggers)";
+        }
+
+        void RunBenchmark() override {
+            std::string module = GenerateModule(300);
+            std::string error;
+
+            ParserSingleton.ResetCounters();
+            ParserSingleton.ParseString(module, error);
+            Parser::Counters counters = ParserSingleton.GetCounters();
+
+            double seconds = TimeBest([&]() {
+                ParserSingleton.ParseString(module, error);
+            });
+
+            size_t visited = counters.calls + counters.avoided;
+
+            Print("    $ generator calls, $ skipped by trigger ($%)\n", counters.calls, counters.avoided, std::to_string(visited ? 100.0 * counters.avoided / visited : 0.0));
+            Print("    Full parse of $ bytes in $ s\n", module.size(), std::to_string(seconds));
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef MARTIN_BENCH_PARSER_VALIDATION
+#define MARTIN_BENCH_PARSER_VALIDATION
+
+#include "benchmark.hpp"
+#include "helpers/synthetic.hpp"
+
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_validation : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Validation)";
+        }
+
+        void RunBenchmark() override {
+            std::string code = GenerateModule(2000);
+            std::string error;
+
+            // Generators ask about the nodes they build on while parsing
+            TreeNodeBase::ResetValidCounters();
+            Tree tree = ParserSingleton.ParseString(code, error);
+            TreeNodeBase::ValidCounters parse = TreeNodeBase::GetValidCounters();
+
+            size_t nodes = 0;
+            Walk(tree, [&](const TokenNode& item) {
+                nodes += !item->is_token;
+                return true;
+            });
+
+            TreeNodeBase::ResetValidCounters();
+            size_t invalid = 0;
+            double first = TimeBest([&]() {
+                invalid = Parser::FindInvalid(tree).size();
+            }, 1);
+            TreeNodeBase::ValidCounters pass = TreeNodeBase::GetValidCounters();
+
+            double again = TimeBest([&]() {
+                invalid = Parser::FindInvalid(tree).size();
+            });
+
+            Print("    $ nodes, $ invalid\n", nodes, invalid);
+            Print("    Parsing: $ Valid calls, $ checks run\n", parse.calls, parse.checks);
+            Print("    First pass: $ Valid calls, $ checks run in $ s, passes after it: $ s\n", pass.calls, pass.checks, std::to_string(first), std::to_string(again));
+        }
+    };
+}
+
+#endif
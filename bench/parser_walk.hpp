@@ -0,0 +1,83 @@
+#ifndef MARTIN_BENCH_PARSER_WALK
+#define MARTIN_BENCH_PARSER_WALK
+
+#include "benchmark.hpp"
+
+#include <parse.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+    class Benchmark_parser_walk : public Benchmark {
+    public:
+        std::string GetName() const override {
+            return "Parser(Walk)";
+        }
+
+        void RunBenchmark() override {
+            // Long chains of operators nest one level per operator
+            std::string code;
+            for (size_t line = 0; line < 200; line++) {
+                code += "let x" + std::to_string(line) + " := a0";
+                for (size_t term = 1; term < 300; term++)
+                    code += ((term % 3) ? " + a" : " * a") + std::to_string(term);
+                code += "\n";
+            }
+
+            std::string error;
+            Tree tree = ParserSingleton.ParseString(code, error);
+
+            size_t found = 0;
+            double splice_seconds = TimeBest([&]() {
+                found = 0;
+                for (auto item : *tree)
+                    found += Splice(item, TreeNodeBase::Type::OP_Mul).size();
+            });
+
+            double walk_seconds = TimeBest([&]() {
+                found = Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::OP_Mul).size();
+            });
+
+            // Stops at the first multiplication of every line
+            size_t first = 0;
+            double exit_seconds = TimeBest([&]() {
+                first = 0;
+                for (auto item : *tree) {
+                    Walk(item, [&](const TokenNode& node) {
+                        if (node->is_token || (node->node->GetType() != TreeNodeBase::Type::OP_Mul))
+                            return true;
+
+                        first++;
+                        return false;
+                    });
+                }
+            });
+
+            Print("    $ multiplications in $ bytes of expressions\n", found, code.size());
+            Print("    Vector per level: $ s, walk: $ s, first of each line: $ s\n", std::to_string(splice_seconds), std::to_string(walk_seconds), std::to_string(exit_seconds));
+        }
+
+    private:
+        // How GetAllNodesOfType used to work, every level building a list
+        // and adding its children's lists to it
+        static std::vector<TreeNode> Splice(const TokenNode& item, TreeNodeBase::Type type) {
+            std::vector<TreeNode> list;
+            if (!item || item->is_token || !item->node)
+                return list;
+
+            if (item->node->GetType() == type)
+                list.push_back(item->node);
+
+            std::vector<TokenNode> children;
+            item->node->GetChildren(children);
+
+            for (auto child : children) {
+                auto list2 = Splice(child, type);
+                list.insert(list.end(), list2.begin(), list2.end());
+            }
+
+            return list;
+        }
+    };
+}
+
+#endif
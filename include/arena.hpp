@@ -0,0 +1,80 @@
+#ifndef MARTIN_ARENA
+#define MARTIN_ARENA
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <stddef.h>
+
+namespace Martin {
+
+    // Owns the nodes made while one file is parsed. They're placed one after
+    // the other in big blocks and destroyed all at once with the arena, so a
+    // node costs no heap allocation of its own. Handles returned by Make
+    // don't own anything, copying them touches no reference count. Nodes
+    // point at each other with them, owning ones would keep the arena alive
+    // forever. Handles that leave a parse alias the arena's shared_ptr instead
+    class AstArena : public std::enable_shared_from_this<AstArena> {
+    public:
+        typedef struct {
+            size_t objects;
+            // Block allocations, objects bigger than a block get their own
+            size_t blocks;
+            size_t bytes;
+        } Stats;
+
+        AstArena() {}
+        ~AstArena();
+
+        AstArena(const AstArena&) = delete;
+        AstArena& operator=(const AstArena&) = delete;
+
+        template <typename T, typename... Args>
+        std::shared_ptr<T> Make(Args&&... args) {
+            T* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            objects.push_back({ object, [](void* object) { static_cast<T*>(object)->~T(); } });
+
+            // Aliasing an empty pointer gives a handle without a control block
+            return std::shared_ptr<T>(std::shared_ptr<T>(), object);
+        }
+
+        Stats GetStats() const;
+
+        // Arena nodes go to on this thread, nullptr outside of a parse
+        static AstArena* GetCurrent();
+
+        // Makes an arena the current one on this thread while it's alive
+        class Scope {
+        public:
+            Scope(AstArena* arena);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            AstArena* previous;
+        };
+
+    private:
+        void* Allocate(size_t size, size_t align);
+
+        struct Object {
+            void* object;
+            void (*destroy)(void*);
+        };
+
+        static const size_t block_size = 1 << 16;
+
+        std::vector<std::unique_ptr<char[]>> blocks;
+        size_t block_used = block_size;
+        std::vector<std::unique_ptr<char[]>> large;
+
+        std::vector<Object> objects;
+        size_t bytes = 0;
+    };
+
+}
+
+#endif
@@ -37,7 +37,7 @@ namespace Martin {
         };
 
         VariableDefinitionBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             const std::vector<TypeDefinition>& types,
             Type type,
             const std::string& extern_type,
@@ -50,7 +50,7 @@ namespace Martin {
                 is_unsafe(is_unsafe),
                 context(context) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         const std::vector<TypeDefinition> types;
         const std::string extern_type;
 
@@ -62,7 +62,7 @@ namespace Martin {
     class FunctionDefinitionBase {
     public:
         FunctionDefinitionBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             const std::vector<VariableDefinition>& arguments,
             const std::vector<TypeDefinition>& types,
             const std::string& extern_type,
@@ -75,7 +75,7 @@ namespace Martin {
             is_unsafe(is_unsafe),
             context(context) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         const std::vector<VariableDefinition> arguments;
         const std::vector<TypeDefinition> types;
         const std::string extern_type;
@@ -103,7 +103,7 @@ namespace Martin {
         } FriendDefinition;
 
         ClassDefinitionBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             const std::vector<InheritDefinition>& inherits,
             const std::vector<FriendDefinition>& friends,
             const std::vector<ObjectDefinition>& public_defines,
@@ -122,7 +122,7 @@ namespace Martin {
             is_unsafe(is_unsafe),
             context(context) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         std::vector<InheritDefinition> inherits;
         std::vector<FriendDefinition> friends;
         std::vector<ObjectDefinition> public_defines;
@@ -192,34 +192,34 @@ namespace Martin {
     class UnionDefinitionBase {
     public:
         typedef struct {
-            std::vector<std::string> names;
+            std::vector<Symbol> names;
             TypeDefinition type;
         } MemberDefinition;
 
         UnionDefinitionBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             const std::vector<MemberDefinition>& members
         ) : name(name),
             members(members) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         std::vector<MemberDefinition> members;
     };
 
     class StructDefinitionBase {
     public:
         typedef struct {
-            std::vector<std::string> names;
+            std::vector<Symbol> names;
             TypeDefinition type;
         } MemberDefinition;
 
         StructDefinitionBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             const std::vector<MemberDefinition>& members
         ) : name(name),
             members(members) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         std::vector<MemberDefinition> members;
     };
 
@@ -242,7 +242,7 @@ namespace Martin {
         };
 
         TypeDefinitionBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             const std::vector<Access>& access,
             Type type,
             PrimitiveDefinition primitive_definition,
@@ -257,7 +257,7 @@ namespace Martin {
             function_definition(function_definition),
             context(context) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         const std::vector<Access> access;
         const Type type;
         
@@ -315,18 +315,18 @@ namespace Martin {
 
         typedef struct {
             Access access;
-            std::shared_ptr<uint8_t[]> name;
+            Symbol name;
         } ImportDefinition;
 
         ImportBase(
-            std::shared_ptr<uint8_t[]> name,
+            Symbol name,
             Access access,
             const std::vector<ImportDefinition>& imports
         ) : name(name),
             access(access),
             imports(imports) {}
 
-        std::shared_ptr<uint8_t[]> name;
+        Symbol name;
         const Access access;
         const std::vector<ImportDefinition> imports;
 
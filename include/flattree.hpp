@@ -0,0 +1,108 @@
+#ifndef MARTIN_FLATTREE
+#define MARTIN_FLATTREE
+
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+#include <parse.hpp>
+#include <tokens.hpp>
+
+namespace Martin {
+
+    class FlatTreeBase;
+    typedef std::shared_ptr<FlatTreeBase> FlatTree;
+
+    // A parse tree laid out as arrays. Every item, node or token, gets an
+    // index in depth first order, so the items of a subtree are the range
+    // from its index up to GetSubtreeEnd. Kinds, child ranges and token
+    // references are arrays indexed by item, scans over them don't touch
+    // the nodes at all. GetItem hands out the node behind an index for code
+    // that still needs the TreeNodeBase API, the items keep their arenas
+    // alive like the tree's own
+    class FlatTreeBase {
+    public:
+        typedef uint32_t Index;
+
+        static constexpr Index None = UINT32_MAX;
+
+        // Null items are left out
+        FlatTreeBase(Tree tree);
+
+        size_t size() const {
+            return kinds.size();
+        }
+
+        // Items at the top level of the tree
+        const std::vector<Index>& GetRoots() const {
+            return roots;
+        }
+
+        bool IsToken(Index index) const {
+            return kinds[index] >= TreeNodeBase::TypeCount;
+        }
+
+        // Only meaningful for nodes
+        TreeNodeBase::Type GetType(Index index) const {
+            return (TreeNodeBase::Type)kinds[index];
+        }
+
+        // Only meaningful for tokens
+        TokenType::Type GetTokenType(Index index) const {
+            return (TokenType::Type)(kinds[index] - TreeNodeBase::TypeCount);
+        }
+
+        // nullptr for nodes
+        Token GetToken(Index index) const {
+            return (token_indices[index] == None) ? nullptr : tokens[token_indices[index]];
+        }
+
+        size_t GetChildCount(Index index) const {
+            return ranges[index].end - ranges[index].begin;
+        }
+
+        Index GetChild(Index index, size_t child) const {
+            return children[ranges[index].begin + child];
+        }
+
+        // None for items at the top level
+        Index GetParent(Index index) const {
+            return parents[index];
+        }
+
+        Index GetSubtreeEnd(Index index) const {
+            return ends[index];
+        }
+
+        const TokenNode& GetItem(Index index) const {
+            return items[index];
+        }
+
+        // Nodes of a type in the same order Parser::GetAllNodesOfType gives them
+        std::vector<Index> FindAll(TreeNodeBase::Type type) const;
+        std::vector<TreeNode> GetAllNodesOfType(TreeNodeBase::Type type) const;
+
+    private:
+        struct Range {
+            Index begin;
+            Index end;
+        };
+
+        // Node type, or TreeNodeBase::TypeCount plus the token type
+        std::vector<uint16_t> kinds;
+        // Where each item's children are in children
+        std::vector<Range> ranges;
+        std::vector<Index> children;
+        std::vector<Index> parents;
+        std::vector<Index> ends;
+        // Into tokens, None for nodes
+        std::vector<Index> token_indices;
+        std::vector<Token> tokens;
+
+        std::vector<Index> roots;
+        std::vector<TokenNode> items;
+    };
+
+}
+
+#endif
@@ -23,14 +23,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-        
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (sizes.size() == 0) return false;
             for (auto it : sizes) {
                 switch (it->GetType()) {
@@ -65,19 +58,8 @@ namespace Martin {
             return right != nullptr;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
         
         const std::vector<Token> sizes;
@@ -101,14 +83,7 @@ namespace Martin {
             
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (right) {
                 if (right->is_token && (right->token->GetType() != TokenType::Type::Identifier))
                     return false;
@@ -131,19 +106,8 @@ namespace Martin {
             return right != nullptr;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -166,14 +130,7 @@ namespace Martin {
             
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (right) {
                 if (right->is_token && (right->token->GetType() != TokenType::Type::Identifier))
                     return false;
@@ -196,19 +153,8 @@ namespace Martin {
             return right != nullptr;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -231,14 +177,7 @@ namespace Martin {
             
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (right) {
                 if (right->is_token && (right->token->GetType() != TokenType::Type::Identifier))
                     return false;
@@ -261,19 +200,8 @@ namespace Martin {
             return right != nullptr;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -296,14 +224,7 @@ namespace Martin {
             
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (right) {
                 if (right->is_token && (right->token->GetType() != TokenType::Type::Identifier))
                     return false;
@@ -326,19 +247,8 @@ namespace Martin {
             return right != nullptr;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -350,7 +260,17 @@ namespace Martin {
             return true;
         }
 
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Array)
+                .Add(TokenType::Type::KW_Reference)
+                .Add(TokenType::Type::KW_Shared)
+                .Add(TokenType::Type::KW_Unique)
+                .Add(TokenType::Type::KW_Pointer);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::KW_Array)) {
                 TokenNode sizes = GetIndexOrNull(tree, index+1);
@@ -405,11 +325,11 @@ namespace Martin {
                             }
                         }
                     }
-                    TreeNode op = TreeNode(new ArrayTypesTreeNode(vsizes, right));
+                    TreeNode op = MakeTreeNode<ArrayTypesTreeNode>(vsizes, right);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 3);
 
@@ -428,25 +348,25 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Reference:
-                            op = TreeNode(new ReferenceTypesTreeNode(right));
+                            op = MakeTreeNode<ReferenceTypesTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Pointer:
-                            op = TreeNode(new PointerTypesTreeNode(right));
+                            op = MakeTreeNode<PointerTypesTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Unique:
-                            op = TreeNode(new UniqueTypesTreeNode(right));
+                            op = MakeTreeNode<UniqueTypesTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Shared:
-                            op = TreeNode(new SharedTypesTreeNode(right));
+                            op = MakeTreeNode<SharedTypesTreeNode>(right);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
 
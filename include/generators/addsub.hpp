@@ -24,14 +24,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
             
             if (left->is_token && right->is_token) {
@@ -66,26 +59,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -159,14 +134,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
             
             if (!ValidateTokenNode(left)) return false;
@@ -175,26 +143,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         TokenNode left;
@@ -254,7 +204,14 @@ namespace Martin {
 
     class OPAddSubTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::SYM_Add)
+                .Add(TokenType::Type::SYM_Sub);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::SYM_Add) ||
@@ -264,19 +221,7 @@ namespace Martin {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    TreeNode op;
-
-                    if (sym->GetType() == TokenType::Type::SYM_Add)
-                        op = TreeNode(new OPAddTreeNode(left, right));
-                    
-                    else
-                        op = TreeNode(new OPSubTreeNode(left, right));
-                        
-                    op->SetLineNumber(sym->GetLineNumber());
-
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
+                    ReplaceTreeWithTokenNode(tree, Create(sym, left, right), index-1, 3);
 
                     return 3;
                 }
@@ -284,6 +229,22 @@ namespace Martin {
 
             return 0;
         }
+
+        static TokenNode Create(Token sym, TokenNode left, TokenNode right) {
+            TreeNode op;
+
+            if (sym->GetType() == TokenType::Type::SYM_Add)
+                op = MakeTreeNode<OPAddTreeNode>(left, right);
+            
+            else
+                op = MakeTreeNode<OPSubTreeNode>(left, right);
+                
+            op->SetLocation(sym->GetLocation());
+
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
     };
 
 }
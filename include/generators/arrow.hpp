@@ -24,14 +24,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (left->is_token) return false;
@@ -111,26 +104,8 @@ namespace Martin {
             return left->node->Valid();
         }
         
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -139,18 +114,23 @@ namespace Martin {
 
     class ArrowTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::SYM_Arrow);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::SYM_Arrow)) {
                 TokenNode left = GetIndexOrNull(tree, index-1);
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    TreeNode op = TreeNode(new ArrowTreeNode(left, right));
+                    TreeNode op = MakeTreeNode<ArrowTreeNode>(left, right);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
 
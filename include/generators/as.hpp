@@ -22,14 +22,7 @@ namespace Martin {
             
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token || (left->token->GetType() != TokenType::Type::Identifier)) return false;
@@ -38,26 +31,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -66,18 +41,23 @@ namespace Martin {
 
     class StructAsTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::KW_As);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::KW_As)) {
                 TokenNode left = GetIndexOrNull(tree, index-1);
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    TreeNode op = TreeNode(new StructAsTreeNode(left, right));
+                    TreeNode op = MakeTreeNode<StructAsTreeNode>(left, right);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
 
@@ -29,14 +29,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (left->is_token && (left->token->GetType() != TokenType::Type::Identifier)) return false;
@@ -95,26 +88,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -137,14 +112,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (left->is_token && (left->token->GetType() != TokenType::Type::Identifier)) return false;
@@ -210,26 +178,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -252,14 +202,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -307,26 +250,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -349,14 +274,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -397,26 +315,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -439,14 +339,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -487,26 +380,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -529,14 +404,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -577,26 +445,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -619,14 +469,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -668,26 +511,8 @@ namespace Martin {
         }
 
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -710,14 +535,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -758,26 +576,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -800,14 +600,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -848,26 +641,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -890,14 +665,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -938,26 +706,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -980,14 +730,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -1028,26 +771,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -1070,14 +795,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -1118,26 +836,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -1160,14 +860,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-        
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -1208,26 +901,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -1250,14 +925,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!left->is_token) return false;
@@ -1298,26 +966,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -1326,7 +976,26 @@ namespace Martin {
 
     class AssignmentsTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::SYM_Assign)
+                .Add(TokenType::Type::SYM_TypeAssign)
+                .Add(TokenType::Type::SYM_AssignAdd)
+                .Add(TokenType::Type::SYM_AssignSub)
+                .Add(TokenType::Type::SYM_AssignMul)
+                .Add(TokenType::Type::SYM_AssignDiv)
+                .Add(TokenType::Type::SYM_AssignMod)
+                .Add(TokenType::Type::SYM_AssignPow)
+                .Add(TokenType::Type::SYM_AssignBitAnd)
+                .Add(TokenType::Type::SYM_AssignBitOr)
+                .Add(TokenType::Type::SYM_AssignBitXOr)
+                .Add(TokenType::Type::SYM_AssignBitNot)
+                .Add(TokenType::Type::SYM_AssignBitShiftLeft)
+                .Add(TokenType::Type::SYM_AssignBitShiftRight);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::SYM_Assign) ||
@@ -1352,65 +1021,65 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::SYM_Assign:
-                            op = TreeNode(new AssignTreeNode(left, right));
+                            op = MakeTreeNode<AssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_TypeAssign:
-                            op = TreeNode(new TypeAssignTreeNode(left, right));
+                            op = MakeTreeNode<TypeAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignAdd:
-                            op = TreeNode(new AddAssignTreeNode(left, right));
+                            op = MakeTreeNode<AddAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignSub:
-                            op = TreeNode(new SubAssignTreeNode(left, right));
+                            op = MakeTreeNode<SubAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignMul:
-                            op = TreeNode(new MulAssignTreeNode(left, right));
+                            op = MakeTreeNode<MulAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignDiv:
-                            op = TreeNode(new DivAssignTreeNode(left, right));
+                            op = MakeTreeNode<DivAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignMod:
-                            op = TreeNode(new ModAssignTreeNode(left, right));
+                            op = MakeTreeNode<ModAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignPow:
-                            op = TreeNode(new PowAssignTreeNode(left, right));
+                            op = MakeTreeNode<PowAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignBitAnd:
-                            op = TreeNode(new BitAndAssignTreeNode(left, right));
+                            op = MakeTreeNode<BitAndAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignBitOr:
-                            op = TreeNode(new BitOrAssignTreeNode(left, right));
+                            op = MakeTreeNode<BitOrAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignBitXOr:
-                            op = TreeNode(new BitXOrAssignTreeNode(left, right));
+                            op = MakeTreeNode<BitXOrAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignBitNot:
-                            op = TreeNode(new BitNotAssignTreeNode(left, right));
+                            op = MakeTreeNode<BitNotAssignTreeNode>(left, right);
                             break;
 
                         case TokenType::Type::SYM_AssignBitShiftLeft:
-                            op = TreeNode(new BitShiftLeftAssignTreeNode(left, right));
+                            op = MakeTreeNode<BitShiftLeftAssignTreeNode>(left, right);
                             break;
                         
                         case TokenType::Type::SYM_AssignBitShiftRight:
-                            op = TreeNode(new BitShiftRightAssignTreeNode(left, right));
+                            op = MakeTreeNode<BitShiftRightAssignTreeNode>(left, right);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
 
@@ -21,14 +21,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -37,26 +30,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -123,14 +98,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
             
             if (!ValidateTokenNode(left)) return false;
@@ -139,26 +107,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -225,14 +175,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
             
             if (!ValidateTokenNode(left)) return false;
@@ -241,26 +184,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -327,14 +252,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
             
             if (!ValidateTokenNode(right)) return false;
@@ -342,18 +260,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -419,14 +327,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
             
             if (!ValidateTokenNode(left)) return false;
@@ -435,26 +336,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -521,14 +404,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
             
             if (!ValidateTokenNode(left)) return false;
@@ -537,26 +413,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
         
         const TokenNode left;
@@ -609,7 +467,18 @@ namespace Martin {
 
     class OPBitwiseTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::SYM_BitAnd)
+                .Add(TokenType::Type::SYM_BitOr)
+                .Add(TokenType::Type::SYM_BitXOr)
+                .Add(TokenType::Type::SYM_BitShiftLeft)
+                .Add(TokenType::Type::SYM_BitShiftRight)
+                .Add(TokenType::Type::SYM_BitNot);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::SYM_BitAnd) ||
@@ -618,39 +487,11 @@ namespace Martin {
                 (sym->GetType() == TokenType::Type::SYM_BitShiftLeft) ||
                 (sym->GetType() == TokenType::Type::SYM_BitShiftRight)
             )) {
-                TreeNode op;
-
                 TokenNode left = GetIndexOrNull(tree, index-1);
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    switch (sym->GetType()) {
-                        case TokenType::Type::SYM_BitAnd:
-                            op = TreeNode(new OPBitAndTreeNode(left, right));
-                            break;
-
-                        case TokenType::Type::SYM_BitOr:
-                            op = TreeNode(new OPBitOrTreeNode(left, right));
-                            break;
-
-                        case TokenType::Type::SYM_BitXOr:
-                            op = TreeNode(new OPBitXOrTreeNode(left, right));
-                            break;
-
-                        case TokenType::Type::SYM_BitShiftLeft:
-                            op = TreeNode(new OPBitShiftLeftTreeNode(left, right));
-                            break;
-
-                        case TokenType::Type::SYM_BitShiftRight:
-                            op = TreeNode(new OPBitShiftRightTreeNode(left, right));
-                            break;
-                    }
-
-                    op->SetLineNumber(sym->GetLineNumber());
-
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
+                    ReplaceTreeWithTokenNode(tree, Create(sym, left, right), index-1, 3);
 
                     return 3;
                 }
@@ -658,13 +499,7 @@ namespace Martin {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (right) {
-                    TreeNode op = TreeNode(new OPBitNotTreeNode(right));
-
-                    op->SetLineNumber(sym->GetLineNumber());
-
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index, 2);
+                    ReplaceTreeWithTokenNode(tree, CreatePrefix(sym, right), index, 2);
 
                     return 2;
                 }
@@ -672,6 +507,48 @@ namespace Martin {
 
             return 0;
         }
+
+        static TokenNode Create(Token sym, TokenNode left, TokenNode right) {
+            TreeNode op;
+
+            switch (sym->GetType()) {
+                case TokenType::Type::SYM_BitAnd:
+                    op = MakeTreeNode<OPBitAndTreeNode>(left, right);
+                    break;
+
+                case TokenType::Type::SYM_BitOr:
+                    op = MakeTreeNode<OPBitOrTreeNode>(left, right);
+                    break;
+
+                case TokenType::Type::SYM_BitXOr:
+                    op = MakeTreeNode<OPBitXOrTreeNode>(left, right);
+                    break;
+
+                case TokenType::Type::SYM_BitShiftLeft:
+                    op = MakeTreeNode<OPBitShiftLeftTreeNode>(left, right);
+                    break;
+
+                case TokenType::Type::SYM_BitShiftRight:
+                    op = MakeTreeNode<OPBitShiftRightTreeNode>(left, right);
+                    break;
+            }
+
+            op->SetLocation(sym->GetLocation());
+
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
+
+        static TokenNode CreatePrefix(Token sym, TokenNode right) {
+            TreeNode op = MakeTreeNode<OPBitNotTreeNode>(right);
+
+            op->SetLocation(sym->GetLocation());
+
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
     };
 
 }
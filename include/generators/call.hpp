@@ -21,14 +21,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *id, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!id || !right) return false;
 
             if (id->is_token) {
@@ -45,26 +38,8 @@ namespace Martin {
             return right->node->Valid();
         }
         
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!id->is_token) {
-                if (id->node->GetType() == type) {
-                    list.push_back(id->node);
-                }
-                auto list2 = id->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(id) && visit.Visit(right);
         }
 
         const TokenNode id;
@@ -73,7 +48,14 @@ namespace Martin {
 
     class CallTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::Identifier)
+                .Add(TreeNodeBase::Type::OP_Dot);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             TokenNode sym = GetIndexOrNull(tree, index);
             if (sym && (
                 (sym->is_token && (sym->token->GetType() == TokenType::Type::Identifier)) ||
@@ -82,15 +64,15 @@ namespace Martin {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (right && !right->is_token && (right->node->GetType() == TreeNodeBase::Type::Struct_Parentheses)) {
-                    TreeNode op = TreeNode(new CallTreeNode(sym, right));
+                    TreeNode op = MakeTreeNode<CallTreeNode>(sym, right);
 
                     if (sym->is_token) {
-                        op->SetLineNumber(sym->token->GetLineNumber());
+                        op->SetLocation(sym->token->GetLocation());
                     } else {
-                        op->SetLineNumber(sym->node->GetLineNumber());
+                        op->SetLocation(sym->node->GetLocation());
                     }
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
 
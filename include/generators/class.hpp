@@ -27,14 +27,7 @@ namespace Martin {
                 serial = Format("$($, nullptr)", *name, GetName());
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!name || !scope) return false;
 
             if (name->is_token && (name->token->GetType() != TokenType::Type::Identifier)) return false;
@@ -66,26 +59,8 @@ namespace Martin {
             return true;
         }
         
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!name->is_token) {
-                if (name->node->GetType() == type) {
-                    list.push_back(name->node);
-                }
-                auto list2 = name->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(name) && visit.Visit(scope);
         }
 
         const TokenNode name;
@@ -106,18 +81,23 @@ namespace Martin {
 
     class ClassTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::KW_Class);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::KW_Class)) {
                 TokenNode name = GetIndexOrNull(tree, index+1);
                 TokenNode scope = GetIndexOrNull(tree, index+2);
 
                 if (name && scope) {
-                    TreeNode op = TreeNode(new ClassTreeNode(name, scope));
+                    TreeNode op = MakeTreeNode<ClassTreeNode>(name, scope);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 3);
 
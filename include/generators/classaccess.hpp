@@ -21,14 +21,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) {
@@ -40,19 +33,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -74,14 +56,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) {
@@ -93,19 +68,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -127,14 +91,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) {
@@ -146,19 +103,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -180,14 +126,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) {
@@ -199,19 +138,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            if (right->is_token) {
-                return {};
-            }
-
-            std::vector<TreeNode> list;
-            if (right->node->GetType() == type) {
-                list.push_back(right->node);
-            }
-            auto list2 = right->node->GetAllNodesOfType(type);
-            list.insert(list.end(), list2.begin(), list2.end());
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -223,7 +151,16 @@ namespace Martin {
             return true;
         }
 
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Public)
+                .Add(TokenType::Type::KW_Protected)
+                .Add(TokenType::Type::KW_Private)
+                .Add(TokenType::Type::KW_Friend);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_Public) ||
@@ -238,25 +175,25 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Public:
-                            op = TreeNode(new ClassAccessPublicTreeNode(right));
+                            op = MakeTreeNode<ClassAccessPublicTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Protected:
-                            op = TreeNode(new ClassAccessProtectedTreeNode(right));
+                            op = MakeTreeNode<ClassAccessProtectedTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Private:
-                            op = TreeNode(new ClassAccessPrivateTreeNode(right));
+                            op = MakeTreeNode<ClassAccessPrivateTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Friend:
-                            op = TreeNode(new ClassAccessFriendTreeNode(right));
+                            op = MakeTreeNode<ClassAccessFriendTreeNode>(right);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
 
@@ -21,14 +21,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) return false;
@@ -50,18 +43,8 @@ namespace Martin {
             }
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -83,14 +66,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) return false;
@@ -112,18 +88,8 @@ namespace Martin {
             }
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -145,14 +111,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (right->is_token) return false;
@@ -174,18 +133,8 @@ namespace Martin {
             }
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -197,7 +146,15 @@ namespace Martin {
             return true;
         }
         
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Virtual)
+                .Add(TokenType::Type::KW_Override)
+                .Add(TokenType::Type::KW_Static);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_Virtual) ||
@@ -211,21 +168,21 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Virtual:
-                            op = TreeNode(new ClassTypeVirtualTreeNode(right));
+                            op = MakeTreeNode<ClassTypeVirtualTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Override:
-                            op = TreeNode(new ClassTypeOverrideTreeNode(right));
+                            op = MakeTreeNode<ClassTypeOverrideTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Static:
-                            op = TreeNode(new ClassTypeStaticTreeNode(right));
+                            op = MakeTreeNode<ClassTypeStaticTreeNode>(right);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
                 }
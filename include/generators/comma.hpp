@@ -27,14 +27,7 @@ namespace Martin {
             serial += ")";
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (nodes.size() == 0) return false;
 
             for (auto it : nodes) {
@@ -46,20 +39,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            for (auto node : nodes) {
-                if (!node->is_token) {
-                    if (node->node->GetType() == type) {
-                        list.push_back(node->node);
-                    }
-                    auto list2 = node->node->GetAllNodesOfType(type);
-                    list.insert(list.end(), list2.begin(), list2.end());
-                }
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.VisitAll(nodes);
         }
 
         const std::vector<TokenNode> nodes;
@@ -67,7 +48,12 @@ namespace Martin {
 
     class StructCommaTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::SYM_Comma);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::SYM_Comma)) {
                 TokenNode left = GetIndexOrNull(tree, index-1);
@@ -80,11 +66,11 @@ namespace Martin {
                         nodes.insert(nodes.begin(), comma_node->nodes.begin(), comma_node->nodes.end());
                         nodes.push_back(right);
 
-                        TreeNode op = TreeNode(new StructCommaTreeNode(nodes));
+                        TreeNode op = MakeTreeNode<StructCommaTreeNode>(nodes);
 
-                        op->SetLineNumber(sym->GetLineNumber());
+                        op->SetLocation(sym->GetLocation());
 
-                        TokenNode token_node = TokenNode(new TokenNodeBase);
+                        TokenNode token_node = MakeTokenNode();
                         token_node->node = op;
                         ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
 
@@ -94,11 +80,11 @@ namespace Martin {
                         nodes.push_back(left);
                         nodes.push_back(right);
 
-                        TreeNode op = TreeNode(new StructCommaTreeNode(nodes));
+                        TreeNode op = MakeTreeNode<StructCommaTreeNode>(nodes);
 
-                        op->SetLineNumber(sym->GetLineNumber());
+                        op->SetLocation(sym->GetLocation());
 
-                        TokenNode token_node = TokenNode(new TokenNodeBase);
+                        TokenNode token_node = MakeTokenNode();
                         token_node->node = op;
                         ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
 
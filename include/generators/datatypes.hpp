@@ -23,14 +23,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *name, *members);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!name || !members) return false;
 
             if (!name->is_token) return false;
@@ -60,26 +53,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!name->is_token) {
-                if (name->node->GetType() == type) {
-                    list.push_back(name->node);
-                }
-                auto list2 = name->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!members->is_token) {
-                if (members->node->GetType() == type) {
-                    list.push_back(members->node);
-                }
-                auto list2 = members->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(name) && visit.Visit(members);
         }
 
         const TokenNode name;
@@ -102,14 +77,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *name, *members);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!name || !members) return false;
 
             if (!name->is_token) return false;
@@ -139,26 +107,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!name->is_token) {
-                if (name->node->GetType() == type) {
-                    list.push_back(name->node);
-                }
-                auto list2 = name->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!members->is_token) {
-                if (members->node->GetType() == type) {
-                    list.push_back(members->node);
-                }
-                auto list2 = members->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(name) && visit.Visit(members);
         }
 
         const TokenNode name;
@@ -181,14 +131,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *name, *members);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!name || !members) return false;
 
             if (!name->is_token) return false;
@@ -225,26 +168,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!name->is_token) {
-                if (name->node->GetType() == type) {
-                    list.push_back(name->node);
-                }
-                auto list2 = name->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!members->is_token) {
-                if (members->node->GetType() == type) {
-                    list.push_back(members->node);
-                }
-                auto list2 = members->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(name) && visit.Visit(members);
         }
 
         const TokenNode name;
@@ -253,7 +178,15 @@ namespace Martin {
 
     class DataTypesTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Struct)
+                .Add(TokenType::Type::KW_Union)
+                .Add(TokenType::Type::KW_Enum);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_Struct) ||
@@ -268,21 +201,21 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Struct:
-                            op = TreeNode(new StructTreeNode(id, members));
+                            op = MakeTreeNode<StructTreeNode>(id, members);
                             break;
                         
                         case TokenType::Type::KW_Union:
-                            op = TreeNode(new UnionTreeNode(id, members));
+                            op = MakeTreeNode<UnionTreeNode>(id, members);
                             break;
                         
                         case TokenType::Type::KW_Enum:
-                            op = TreeNode(new EnumTreeNode(id, members));
+                            op = MakeTreeNode<EnumTreeNode>(id, members);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 3);
 
@@ -42,14 +42,7 @@ namespace Martin {
                 serial = Format("$, nullptr)", serial);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (ids.size() == 0) return false;
             if (!types) return false;
 
@@ -94,21 +87,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            // Because types is nullptr in the code 'let a := 0'
-            if (!types) return {};
-
-            if (!types->is_token) {
-                if (types->node->GetType() == type) {
-                    list.push_back(types->node);
-                }
-                auto list2 = types->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(types);
         }
 
         const std::vector<Token> ids;
@@ -150,14 +130,7 @@ namespace Martin {
                 serial = Format("$, nullptr)", serial);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (ids.size() == 0) return false;
             if (types == nullptr) return false;
 
@@ -202,20 +175,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!types) return {};
-
-            if (!types->is_token) {
-                if (types->node->GetType() == type) {
-                    list.push_back(types->node);
-                }
-                auto list2 = types->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(types);
         }
 
         const std::vector<Token> ids;
@@ -257,14 +218,7 @@ namespace Martin {
                 serial = Format("$, nullptr)", serial);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (ids.size() == 0) return false;
             if (!types) return false;
 
@@ -309,20 +263,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!types) return {};
-
-            if (!types->is_token) {
-                if (types->node->GetType() == type) {
-                    list.push_back(types->node);
-                }
-                auto list2 = types->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(types);
         }
 
         const std::vector<Token> ids;
@@ -364,14 +306,7 @@ namespace Martin {
                 serial = Format("$, nullptr)", serial);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (ids.size() == 0) return false;
             if (!types) return false;
 
@@ -416,20 +351,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!types) return {};
-
-            if (!types->is_token) {
-                if (types->node->GetType() == type) {
-                    list.push_back(types->node);
-                }
-                auto list2 = types->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(types);
         }
 
         const std::vector<Token> ids;
@@ -471,20 +394,8 @@ namespace Martin {
                 serial = Format("$, nullptr)", serial);
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!types) return {};
-
-            if (!types->is_token) {
-                if (types->node->GetType() == type) {
-                    list.push_back(types->node);
-                }
-                auto list2 = types->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(types);
         }
 
         const std::vector<Token> ids;
@@ -493,7 +404,17 @@ namespace Martin {
 
     class DefinitionsTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Let)
+                .Add(TokenType::Type::KW_Set)
+                .Add(TokenType::Type::KW_Const)
+                .Add(TokenType::Type::KW_Constexpr)
+                .Add(TokenType::Type::KW_Typedef);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_Let) ||
@@ -525,29 +446,29 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Let:
-                            op = TreeNode(new LetTreeNode(ids, types));
+                            op = MakeTreeNode<LetTreeNode>(ids, types);
                             break;
                         
                         case TokenType::Type::KW_Set:
-                            op = TreeNode(new SetTreeNode(ids, types));
+                            op = MakeTreeNode<SetTreeNode>(ids, types);
                             break;
                         
                         case TokenType::Type::KW_Const:
-                            op = TreeNode(new ConstTreeNode(ids, types));
+                            op = MakeTreeNode<ConstTreeNode>(ids, types);
                             break;
                         
                         case TokenType::Type::KW_Constexpr:
-                            op = TreeNode(new ConstexprTreeNode(ids, types));
+                            op = MakeTreeNode<ConstexprTreeNode>(ids, types);
                             break;
 
                         case TokenType::Type::KW_Typedef:
-                            op = TreeNode(new TypedefTreeNode(ids, types));
+                            op = MakeTreeNode<TypedefTreeNode>(ids, types);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, i+3 - index);
 
@@ -557,29 +478,29 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Let:
-                            op = TreeNode(new LetTreeNode(ids, nullptr));
+                            op = MakeTreeNode<LetTreeNode>(ids, nullptr);
                             break;
                         
                         case TokenType::Type::KW_Set:
-                            op = TreeNode(new SetTreeNode(ids, nullptr));
+                            op = MakeTreeNode<SetTreeNode>(ids, nullptr);
                             break;
                         
                         case TokenType::Type::KW_Const:
-                            op = TreeNode(new ConstTreeNode(ids, nullptr));
+                            op = MakeTreeNode<ConstTreeNode>(ids, nullptr);
                             break;
                         
                         case TokenType::Type::KW_Constexpr:
-                            op = TreeNode(new ConstexprTreeNode(ids, nullptr));
+                            op = MakeTreeNode<ConstexprTreeNode>(ids, nullptr);
                             break;
 
                         case TokenType::Type::KW_Typedef:
-                            op = TreeNode(new TypedefTreeNode(ids, nullptr));
+                            op = MakeTreeNode<TypedefTreeNode>(ids, nullptr);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, i+1 - index);
 
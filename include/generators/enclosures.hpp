@@ -29,14 +29,7 @@ namespace Martin {
             serial += ")";
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!inside) return false;
 
             for (auto it : (*inside)) {
@@ -48,20 +41,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            for (auto node : *inside) {
-                if (!node->is_token) {
-                    if (node->node->GetType() == type) {
-                        list.push_back(node->node);
-                    }
-                    auto list2 = node->node->GetAllNodesOfType(type);
-                    list.insert(list.end(), list2.begin(), list2.end());
-                }
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.VisitAll(*inside);
         }
 
         const Tree inside;
@@ -89,14 +70,7 @@ namespace Martin {
             serial += ")";
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!inside) return false;
 
             for (auto it : (*inside)) {
@@ -108,20 +82,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            for (auto node : *inside) {
-                if (!node->is_token) {
-                    if (node->node->GetType() == type) {
-                        list.push_back(node->node);
-                    }
-                    auto list2 = node->node->GetAllNodesOfType(type);
-                    list.insert(list.end(), list2.begin(), list2.end());
-                }
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.VisitAll(*inside);
         }
 
         const Tree inside;
@@ -149,14 +111,7 @@ namespace Martin {
             serial += ")";
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!inside) return false;
 
             for (auto it : (*inside)) {
@@ -168,102 +123,151 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            for (auto node : *inside) {
-                if (!node->is_token) {
-                    if (node->node->GetType() == type) {
-                        list.push_back(node->node);
-                    }
-                    auto list2 = node->node->GetAllNodesOfType(type);
-                    list.insert(list.end(), list2.begin(), list2.end());
-                }
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.VisitAll(*inside);
         }
 
         const Tree inside;
     };
 
+    // Builds every enclosure of a branch in one walk. Each opener is paired
+    // with its closer up front, with one stack per bracket kind, so a pair
+    // is the opener and the first closer of its kind that leaves more
+    // closers than openers behind it. Pairs are then built bottom up: items
+    // go straight into the innermost open enclosure, which gets parsed and
+    // turned into a node once its closer comes. Like scanning from each
+    // opener, a pair only counts when its closer lies inside the enclosure
+    // or branch the opener is in, and only [start, end) is looked at
     class StructEnclosuresTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
-            Token sym = GetIndexOrNullToken(tree, index);
-            if (sym && (
-                (sym->GetType() == TokenType::Type::SYM_OpenCurly) ||
-                (sym->GetType() == TokenType::Type::SYM_OpenBracket) ||
-                (sym->GetType() == TokenType::Type::SYM_OpenParentheses)
-            )) {
-                TokenType::Type opener, closer;
-                opener = sym->GetType();
-
-                switch (opener) {
-                    case TokenType::Type::SYM_OpenCurly:
-                        closer = TokenType::Type::SYM_CloseCurly;
-                        break;
-                    
-                    case TokenType::Type::SYM_OpenBracket:
-                        closer = TokenType::Type::SYM_CloseBracket;
-                        break;
-                    
-                    case TokenType::Type::SYM_OpenParentheses:
-                        closer = TokenType::Type::SYM_CloseParentheses;
-                        break;
+        bool IsRanged() const override {
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
+            return 0;
+        }
+
+        size_t ProcessRange(ParseSession& session, Tree tree, size_t start, size_t end) override {
+            if (!tree)
+                Fatal("Trying to parse a nullptr tree\n");
+
+            size_t size = tree->size();
+            std::vector<size_t> closers = MatchBrackets(*tree, start, end);
+
+            struct Enclosure {
+                Token opener;
+                size_t closer;
+                Tree inside;
+            };
+
+            std::vector<Enclosure> open;
+            Tree out = Tree(new TreeBase);
+            out->reserve(size);
+
+            for (size_t i = 0; i < size; i++) {
+                TokenNode item = (*tree)[i];
+                Tree target = open.empty() ? out : open.back().inside;
+
+                if ((i < start) || (i >= end)) {
+                    target->push_back(item);
+                    continue;
+                }
+
+                if (!open.empty() && (i == open.back().closer)) {
+                    Enclosure enclosure = open.back();
+                    open.pop_back();
+
+                    session.ParseBranch(enclosure.inside, 0, enclosure.inside->size());
+
+                    target = open.empty() ? out : open.back().inside;
+                    target->push_back(Create(enclosure.opener, enclosure.inside));
+                    continue;
+                }
+
+                size_t limit = open.empty() ? end : open.back().closer;
+                size_t closer = closers[i - start];
+
+                if ((closer != npos) && (closer < limit)) {
+                    open.push_back({ item->token, closer, Tree(new TreeBase) });
+                    continue;
                 }
 
-                size_t closer_pos = index;
-                int counter = 0;
-                Token other_sym;
-                for (size_t i = index + 1; i < end; i++) {
-                    other_sym = GetIndexOrNullToken(tree, i);
-
-                    if (other_sym->GetType() == opener)
-                        counter++;
-                    
-                    else if (other_sym->GetType() == closer)
-                        counter--;
-                    
-                    if (counter < 0) {
-                        size_t before = tree->size();
-                        Tree new_tree = Tree(new std::vector<TokenNode>);
-                        new_tree->insert(new_tree->begin(), tree->begin() + index + 1, tree->begin() + i);
-                        tree->erase(tree->begin() + index + 1, tree->begin() + i);
-                        RemoveTreeIndex(tree, index+1);
-                        RemoveTreeIndex(tree, index);
-                        size_t shrinked = before - tree->size();
-
-                        ParserSingleton.ParseBranch(new_tree, 0, new_tree->size());
-
-                        TreeNode op;
-
-                        switch (opener) {
-                            case TokenType::Type::SYM_OpenCurly:
-                                op = TreeNode(new StructCurlyTreeNode(new_tree));
-                                break;
-                            
-                            case TokenType::Type::SYM_OpenBracket:
-                                op = TreeNode(new StructBracketTreeNode(new_tree));
-                                break;
-                            
-                            case TokenType::Type::SYM_OpenParentheses:
-                                op = TreeNode(new StructParenthesesTreeNode(new_tree));
-                                break;
-                        }
-
-                        op->SetLineNumber(sym->GetLineNumber());
-
-                        TokenNode token_node = TokenNode(new TokenNodeBase);
-                        token_node->node = op;
-
-                        tree->insert(tree->begin() + index, token_node);
-
-                        return shrinked;
+                target->push_back(item);
+            }
+
+            tree->swap(*out);
+
+            return size - tree->size();
+        }
+
+    private:
+        static constexpr size_t npos = (size_t)-1;
+
+        // Index of the closer of every opener in [start, end), npos for
+        // everything else
+        static std::vector<size_t> MatchBrackets(const TreeBase& tree, size_t start, size_t end) {
+            static const TokenType::Type openers[] = {
+                TokenType::Type::SYM_OpenCurly,
+                TokenType::Type::SYM_OpenBracket,
+                TokenType::Type::SYM_OpenParentheses
+            };
+
+            static const TokenType::Type closers_of[] = {
+                TokenType::Type::SYM_CloseCurly,
+                TokenType::Type::SYM_CloseBracket,
+                TokenType::Type::SYM_CloseParentheses
+            };
+
+            std::vector<size_t> closers(end - start, npos);
+            std::vector<size_t> stacks[3];
+
+            for (size_t i = start; i < end; i++) {
+                const TokenNode& item = tree[i];
+                if (!item->is_token)
+                    continue;
+
+                TokenType::Type type = item->token->GetType();
+
+                for (size_t kind = 0; kind < 3; kind++) {
+                    if (type == openers[kind]) {
+                        stacks[kind].push_back(i);
+                        break;
+                    }
+
+                    if ((type == closers_of[kind]) && !stacks[kind].empty()) {
+                        closers[stacks[kind].back() - start] = i;
+                        stacks[kind].pop_back();
+                        break;
                     }
                 }
             }
-            return 0;
+
+            return closers;
+        }
+
+        static TokenNode Create(Token sym, Tree inside) {
+            TreeNode op;
+
+            switch (sym->GetType()) {
+                case TokenType::Type::SYM_OpenCurly:
+                    op = MakeTreeNode<StructCurlyTreeNode>(inside);
+                    break;
+                
+                case TokenType::Type::SYM_OpenBracket:
+                    op = MakeTreeNode<StructBracketTreeNode>(inside);
+                    break;
+                
+                default:
+                    op = MakeTreeNode<StructParenthesesTreeNode>(inside);
+                    break;
+            }
+
+            op->SetLocation(sym->GetLocation());
+
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
         }
     };
 
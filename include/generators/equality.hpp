@@ -3,6 +3,8 @@
 
 #include <parse.hpp>
 
+#include "enclosures.hpp"
+
 namespace Martin {
 
     class OPEqualsTreeNode : public TreeNodeBase {
@@ -21,14 +23,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -37,26 +32,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -134,14 +111,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -150,26 +120,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -247,14 +199,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -263,26 +208,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -359,14 +286,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -375,26 +295,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -471,14 +373,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -487,26 +382,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -583,14 +460,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -599,26 +469,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -681,7 +533,18 @@ namespace Martin {
 
     class OPEqualityTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::SYM_Equals)
+                .Add(TokenType::Type::SYM_NotEquals)
+                .Add(TokenType::Type::SYM_LessThan)
+                .Add(TokenType::Type::SYM_GreaterThan)
+                .Add(TokenType::Type::SYM_LessThanEquals)
+                .Add(TokenType::Type::SYM_GreaterThanEquals);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::SYM_Equals) ||
@@ -695,39 +558,7 @@ namespace Martin {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    TreeNode op;
-
-                    switch (sym->GetType()) {
-                        case TokenType::Type::SYM_Equals:
-                            op = TreeNode(new OPEqualsTreeNode(left, right));
-                            break;
-                        
-                        case TokenType::Type::SYM_NotEquals:
-                            op = TreeNode(new OPNotEqualsTreeNode(left, right));
-                            break;
-                        
-                        case TokenType::Type::SYM_LessThan:
-                            op = TreeNode(new OPLessThanTreeNode(left, right));
-                            break;
-                        
-                        case TokenType::Type::SYM_GreaterThan:
-                            op = TreeNode(new OPGreaterThanTreeNode(left, right));
-                            break;
-                        
-                        case TokenType::Type::SYM_LessThanEquals:
-                            op = TreeNode(new OPLessThanEqualsTreeNode(left, right));
-                            break;
-                        
-                        case TokenType::Type::SYM_GreaterThanEquals:
-                            op = TreeNode(new OPGreaterThanEqualsTreeNode(left, right));
-                            break;
-                    }
-
-                    op->SetLineNumber(sym->GetLineNumber());
-
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
+                    ReplaceTreeWithTokenNode(tree, Create(sym, left, right), index-1, 3);
 
                     return 3;
                 }
@@ -735,6 +566,42 @@ namespace Martin {
 
             return 0;
         }
+
+        static TokenNode Create(Token sym, TokenNode left, TokenNode right) {
+            TreeNode op;
+
+            switch (sym->GetType()) {
+                case TokenType::Type::SYM_Equals:
+                    op = MakeTreeNode<OPEqualsTreeNode>(left, right);
+                    break;
+                
+                case TokenType::Type::SYM_NotEquals:
+                    op = MakeTreeNode<OPNotEqualsTreeNode>(left, right);
+                    break;
+                
+                case TokenType::Type::SYM_LessThan:
+                    op = MakeTreeNode<OPLessThanTreeNode>(left, right);
+                    break;
+                
+                case TokenType::Type::SYM_GreaterThan:
+                    op = MakeTreeNode<OPGreaterThanTreeNode>(left, right);
+                    break;
+                
+                case TokenType::Type::SYM_LessThanEquals:
+                    op = MakeTreeNode<OPLessThanEqualsTreeNode>(left, right);
+                    break;
+                
+                case TokenType::Type::SYM_GreaterThanEquals:
+                    op = MakeTreeNode<OPGreaterThanEqualsTreeNode>(left, right);
+                    break;
+            }
+
+            op->SetLocation(sym->GetLocation());
+
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
     };
 
 }
@@ -0,0 +1,228 @@
+#ifndef MARTIN_GENERATOR_EXPRESSIONS
+#define MARTIN_GENERATOR_EXPRESSIONS
+
+#include <parse.hpp>
+
+#include "muldivmod.hpp"
+#include "pow.hpp"
+#include "addsub.hpp"
+#include "bitwise.hpp"
+#include "equality.hpp"
+#include "logical.hpp"
+
+namespace Martin {
+
+    // Builds the operator nodes of MulDivMod, Pow, AddSub, Bitwise,
+    // Equality, NotLogic and Logicals in one left to right walk instead of
+    // one sweep each. Every item goes through a chain of precedence levels,
+    // in the order those generators ran, and each level does what its
+    // sweep did: a binary operator takes the item left of it and the next
+    // item as it is, a prefix operator takes the next item as it is. Only
+    // operators that were inside [start, end) to begin with are reduced,
+    // same as the sweeps
+    class OPExpressionsTreeGenerator : public TreeNodeGenerator {
+    public:
+        static const size_t levels = 7;
+
+        enum class Role {
+            None,
+            Binary,
+            Prefix
+        };
+
+        bool IsRanged() const override {
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
+            return 0;
+        }
+
+        size_t ProcessRange(ParseSession& session, Tree tree, size_t start, size_t end) override {
+            if (!tree)
+                Fatal("Trying to parse a nullptr tree\n");
+
+            size_t size = tree->size();
+
+            Walk walk;
+            walk.out.reserve(size);
+
+            for (size_t i = 0; i < size; i++)
+                walk.Push(0, { (*tree)[i], (i >= start) && (i < end) });
+
+            walk.Finish(0);
+
+            tree->swap(walk.out);
+
+            return size - tree->size();
+        }
+
+        static Role GetRole(TokenType::Type type, size_t level) {
+            switch (level) {
+                case 0:
+                    if ((type == TokenType::Type::SYM_Mul) || (type == TokenType::Type::SYM_Div) || (type == TokenType::Type::SYM_Mod))
+                        return Role::Binary;
+                    break;
+
+                case 1:
+                    if (type == TokenType::Type::SYM_Pow)
+                        return Role::Binary;
+                    break;
+
+                case 2:
+                    if ((type == TokenType::Type::SYM_Add) || (type == TokenType::Type::SYM_Sub))
+                        return Role::Binary;
+                    break;
+
+                case 3:
+                    switch (type) {
+                        case TokenType::Type::SYM_BitAnd:
+                        case TokenType::Type::SYM_BitOr:
+                        case TokenType::Type::SYM_BitXOr:
+                        case TokenType::Type::SYM_BitShiftLeft:
+                        case TokenType::Type::SYM_BitShiftRight:
+                            return Role::Binary;
+
+                        case TokenType::Type::SYM_BitNot:
+                            return Role::Prefix;
+
+                        default:
+                            break;
+                    }
+                    break;
+
+                case 4:
+                    switch (type) {
+                        case TokenType::Type::SYM_Equals:
+                        case TokenType::Type::SYM_NotEquals:
+                        case TokenType::Type::SYM_LessThan:
+                        case TokenType::Type::SYM_GreaterThan:
+                        case TokenType::Type::SYM_LessThanEquals:
+                        case TokenType::Type::SYM_GreaterThanEquals:
+                            return Role::Binary;
+
+                        default:
+                            break;
+                    }
+                    break;
+
+                case 5:
+                    if (type == TokenType::Type::KW_Not)
+                        return Role::Prefix;
+                    break;
+
+                case 6:
+                    if ((type == TokenType::Type::KW_And) || (type == TokenType::Type::KW_Or) || (type == TokenType::Type::KW_Not))
+                        return Role::Binary;
+                    break;
+            }
+
+            return Role::None;
+        }
+
+        static TokenNode Create(Token sym, TokenNode left, TokenNode right, size_t level) {
+            switch (level) {
+                case 0: return OPMulDivModTreeGenerator::Create(sym, left, right);
+                case 1: return OPPowTreeGenerator::Create(sym, left, right);
+                case 2: return OPAddSubTreeGenerator::Create(sym, left, right);
+                case 3: return OPBitwiseTreeGenerator::Create(sym, left, right);
+                case 4: return OPEqualityTreeGenerator::Create(sym, left, right);
+                default: return OPLogicalsTreeGenerator::Create(sym, left, right);
+            }
+        }
+
+        static TokenNode CreatePrefix(Token sym, TokenNode right, size_t level) {
+            if (level == 3)
+                return OPBitwiseTreeGenerator::CreatePrefix(sym, right);
+
+            return OPNotLogicTreeGenerator::CreatePrefix(sym, right);
+        }
+
+    private:
+        struct Item {
+            TokenNode node;
+            // Whether the sweeps would have looked at it as an operator
+            bool in_range;
+        };
+
+        struct Level {
+            // The last item this level let through, it stays here while a
+            // binary operator after it can still take it as its left side
+            Item held;
+            // Operator waiting for the item on its right
+            Item pending;
+            Role pending_role = Role::None;
+        };
+
+        struct Walk {
+            Level stack[levels];
+            TreeBase out;
+
+            void Push(size_t level, const Item& item) {
+                if (level == levels) {
+                    out.push_back(item.node);
+                    return;
+                }
+
+                Level& current = stack[level];
+
+                if (current.pending_role == Role::Binary) {
+                    current.held = { Create(current.pending.node->token, current.held.node, item.node, level), false };
+                    current.pending_role = Role::None;
+                    return;
+                }
+
+                if (current.pending_role == Role::Prefix) {
+                    Emit(level);
+                    current.held = { CreatePrefix(current.pending.node->token, item.node, level), false };
+                    current.pending_role = Role::None;
+                    return;
+                }
+
+                Role role = Role::None;
+                if (item.in_range && item.node->is_token)
+                    role = GetRole(item.node->token->GetType(), level);
+
+                if ((role == Role::Binary) && current.held.node) {
+                    current.pending = item;
+                    current.pending_role = role;
+                } else if (role == Role::Prefix) {
+                    current.pending = item;
+                    current.pending_role = role;
+                } else {
+                    Emit(level);
+                    current.held = item;
+                }
+            }
+
+            // Operators still waiting at the end had nothing on their right
+            // and stay tokens
+            void Finish(size_t level) {
+                if (level == levels)
+                    return;
+
+                Level& current = stack[level];
+
+                Emit(level);
+                if (current.pending_role != Role::None) {
+                    Push(level + 1, current.pending);
+                    current.pending_role = Role::None;
+                }
+
+                Finish(level + 1);
+            }
+
+            void Emit(size_t level) {
+                Level& current = stack[level];
+
+                if (current.held.node) {
+                    Push(level + 1, current.held);
+                    current.held.node = nullptr;
+                }
+            }
+        };
+    };
+
+}
+
+#endif
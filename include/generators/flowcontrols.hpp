@@ -23,14 +23,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!condition | !scope) return false;
 
             if (condition->is_token) {
@@ -70,26 +63,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(condition) && visit.Visit(scope);
         }
 
         const TokenNode condition;
@@ -112,14 +87,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!condition | !scope) return false;
 
             if (condition->is_token) {
@@ -159,26 +127,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(condition) && visit.Visit(scope);
         }
 
         const TokenNode condition;
@@ -201,14 +151,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!scope) return false;
             if (scope->is_token) return false;
             if (!scope->node->Valid()) return false;
@@ -217,18 +160,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(scope);
         }
 
         const TokenNode scope;
@@ -250,14 +183,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!condition | !scope) return false;
 
             if (condition->is_token) {
@@ -297,26 +223,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(condition) && visit.Visit(scope);
         }
 
         const TokenNode condition;
@@ -339,14 +247,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (start) {
                 if (start->is_token) return false;
                 if (!start->node->Valid()) return false;
@@ -399,43 +300,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!start->is_token) {
-                if (start->node->GetType() == type) {
-                    list.push_back(start->node);
-                }
-                auto list2 = start->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!increment->is_token) {
-                if (increment->node->GetType() == type) {
-                    list.push_back(increment->node);
-                }
-                auto list2 = increment->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(start) && visit.Visit(condition) && visit.Visit(increment) && visit.Visit(scope);
         }
         
         const TokenNode start;
@@ -460,14 +326,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!condition || !scope) return false;
 
             if (condition->is_token) return false;
@@ -481,26 +340,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(condition) && visit.Visit(scope);
         }
 
         const TokenNode condition;
@@ -523,14 +364,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!condition || !scope) return false;
 
             if (condition->is_token) {
@@ -566,26 +400,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(condition) && visit.Visit(scope);
         }
 
         const TokenNode condition;
@@ -608,14 +424,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *condition, *scope);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!condition || !scope) return false;
 
             if (condition->is_token) {
@@ -650,26 +459,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!condition->is_token) {
-                if (condition->node->GetType() == type) {
-                    list.push_back(condition->node);
-                }
-                auto list2 = condition->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(condition) && visit.Visit(scope);
         }
 
         const TokenNode condition;
@@ -726,31 +517,14 @@ namespace Martin {
             serial = Format("$($)", GetName(), *returns);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!returns) return false;
 
             return ValidateTokenNode(returns);
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!returns->is_token) {
-                if (returns->node->GetType() == type) {
-                    list.push_back(returns->node);
-                }
-                auto list2 = returns->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(returns);
         }
 
         const TokenNode returns;
@@ -806,7 +580,23 @@ namespace Martin {
 
     class FlowControlsTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_If)
+                .Add(TokenType::Type::KW_Elif)
+                .Add(TokenType::Type::KW_While)
+                .Add(TokenType::Type::KW_For)
+                .Add(TokenType::Type::KW_Foreach)
+                .Add(TokenType::Type::KW_Switch)
+                .Add(TokenType::Type::KW_Match)
+                .Add(TokenType::Type::KW_Else)
+                .Add(TokenType::Type::KW_Return)
+                .Add(TokenType::Type::KW_Continue)
+                .Add(TokenType::Type::KW_Break);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_If) ||
@@ -834,15 +624,15 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_If:
-                            op = TreeNode(new FlowControlIfTreeNode((*cond_tree)[0], scope));
+                            op = MakeTreeNode<FlowControlIfTreeNode>((*cond_tree)[0], scope);
                             break;
                         
                         case TokenType::Type::KW_Elif:
-                            op = TreeNode(new FlowControlElifTreeNode((*cond_tree)[0], scope));
+                            op = MakeTreeNode<FlowControlElifTreeNode>((*cond_tree)[0], scope);
                             break;
                         
                         case TokenType::Type::KW_While:
-                            op = TreeNode(new FlowControlWhileTreeNode((*cond_tree)[0], scope));
+                            op = MakeTreeNode<FlowControlWhileTreeNode>((*cond_tree)[0], scope);
                             break;
 
                         case TokenType::Type::KW_For: {
@@ -863,26 +653,26 @@ namespace Martin {
                                     return 0;
                                 }
 
-                                op = TreeNode(new FlowControlForTreeNode(start, cond, incr, scope));
+                                op = MakeTreeNode<FlowControlForTreeNode>(start, cond, incr, scope);
                                 break;
                             }
                         
                         case TokenType::Type::KW_Foreach:
-                            op = TreeNode(new FlowControlForeachTreeNode((*cond_tree)[0], scope));
+                            op = MakeTreeNode<FlowControlForeachTreeNode>((*cond_tree)[0], scope);
                             break;
                         
                         case TokenType::Type::KW_Switch:
-                            op = TreeNode(new FlowControlSwitchTreeNode((*cond_tree)[0], scope));
+                            op = MakeTreeNode<FlowControlSwitchTreeNode>((*cond_tree)[0], scope);
                             break;
                         
                         case TokenType::Type::KW_Match:
-                            op = TreeNode(new FlowControlMatchTreeNode((*cond_tree)[0], scope));
+                            op = MakeTreeNode<FlowControlMatchTreeNode>((*cond_tree)[0], scope);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 3);
 
@@ -899,17 +689,17 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Else:
-                            op = TreeNode(new FlowControlElseTreeNode(right));
+                            op = MakeTreeNode<FlowControlElseTreeNode>(right);
                             break;
                         
                         case TokenType::Type::KW_Return:
-                            op = TreeNode(new FlowControlReturnTreeNode(right));
+                            op = MakeTreeNode<FlowControlReturnTreeNode>(right);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
 
@@ -923,17 +713,17 @@ namespace Martin {
 
                 switch (sym->GetType()) {
                     case TokenType::Type::KW_Continue:
-                        op = TreeNode(new FlowControlContinueTreeNode);
+                        op = MakeTreeNode<FlowControlContinueTreeNode>();
                         break;
                     
                     case TokenType::Type::KW_Break:
-                        op = TreeNode(new FlowControlBreakTreeNode);
+                        op = MakeTreeNode<FlowControlBreakTreeNode>();
                         break;
                 }
 
-                op->SetLineNumber(sym->GetLineNumber());
+                op->SetLocation(sym->GetLocation());
 
-                TokenNode token_node = TokenNode(new TokenNodeBase);
+                TokenNode token_node = MakeTokenNode();
                 token_node->node = op;
                 ReplaceTreeWithTokenNode(tree, token_node, index, 1);
 
@@ -46,14 +46,7 @@ namespace Martin {
             }
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (ids.size() == 0) return false;
             if ((imports.size() != 0) && (ids.size() != 1)) return false;
 
@@ -90,30 +83,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            for (auto node : ids) {
-                if (!node->is_token) {
-                    if (node->node->GetType() == type) {
-                        list.push_back(node->node);
-                    }
-                    auto list2 = node->node->GetAllNodesOfType(type);
-                    list.insert(list.end(), list2.begin(), list2.end());
-                }
-            }
-
-            for (auto node : imports) {
-                if (!node->is_token) {
-                    if (node->node->GetType() == type) {
-                        list.push_back(node->node);
-                    }
-                    auto list2 = node->node->GetAllNodesOfType(type);
-                    list.insert(list.end(), list2.begin(), list2.end());
-                }
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.VisitAll(ids) && visit.VisitAll(imports);
         }
 
         const std::vector<TokenNode> ids;
@@ -122,7 +93,14 @@ namespace Martin {
 
     class MiscFromImportTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Import)
+                .Add(TokenType::Type::KW_From);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::KW_Import)) {
                 TokenNode id = GetIndexOrNull(tree, index+1);
@@ -147,11 +125,11 @@ namespace Martin {
                         } else return 0;
                     }
 
-                    TreeNode op = TreeNode(new MiscFromImportTreeNode(ids, vimports));
+                    TreeNode op = MakeTreeNode<MiscFromImportTreeNode>(ids, vimports);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
                     return 2;
@@ -194,11 +172,11 @@ namespace Martin {
                         } else return 0;
                     }
 
-                    TreeNode op = TreeNode(new MiscFromImportTreeNode(ids, vimports));
+                    TreeNode op = MakeTreeNode<MiscFromImportTreeNode>(ids, vimports);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 4);
                     return 4;
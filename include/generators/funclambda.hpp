@@ -25,14 +25,7 @@ namespace Martin {
                 serial = Format("$($, nullptr)", GetName(), *arrow);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!arrow) return false;
             
             if (arrow->is_token) return false;
@@ -48,26 +41,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!arrow->is_token) {
-                if (arrow->node->GetType() == type) {
-                    list.push_back(arrow->node);
-                }
-                auto list2 = arrow->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (scope &&(!scope->is_token)) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(arrow) && visit.Visit(scope);
         }
 
         const TokenNode arrow;
@@ -93,14 +68,7 @@ namespace Martin {
                 serial = Format("$($, nullptr)", GetName(), *arrow);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!arrow || !scope) return false;
 
             if (arrow->is_token) return false;
@@ -114,26 +82,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!arrow->is_token) {
-                if (arrow->node->GetType() == type) {
-                    list.push_back(arrow->node);
-                }
-                auto list2 = arrow->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            if (!scope->is_token) {
-                if (scope->node->GetType() == type) {
-                    list.push_back(scope->node);
-                }
-                auto list2 = scope->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(arrow) && visit.Visit(scope);
         }
 
         const TokenNode arrow;
@@ -145,28 +95,33 @@ namespace Martin {
 
     class FuncTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::KW_Func);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::KW_Func)) {
                 TokenNode arrow = GetIndexOrNull(tree, index+1);
                 TokenNode scope = GetIndexOrNull(tree, index+2);
 
                 if (arrow && scope && (!scope->is_token) && (scope->node->GetType() == TreeNodeBase::Type::Struct_Curly)) {
-                    TreeNode op = TreeNode(new FuncTreeNode(arrow, scope));
+                    TreeNode op = MakeTreeNode<FuncTreeNode>(arrow, scope);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 3);
 
                     return 3;
                 } else if (arrow) {
-                    TreeNode op = TreeNode(new FuncTreeNode(arrow, nullptr));
+                    TreeNode op = MakeTreeNode<FuncTreeNode>(arrow, nullptr);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
 
@@ -179,18 +134,23 @@ namespace Martin {
 
     class LambdaTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::KW_Lambda);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (sym->GetType() == TokenType::Type::KW_Lambda)) {
                 TokenNode arrow = GetIndexOrNull(tree, index+1);
                 TokenNode scope = GetIndexOrNull(tree, index+2);
 
                 if (arrow && scope) {
-                    TreeNode op = TreeNode(new LambdaTreeNode(arrow, scope));
+                    TreeNode op = MakeTreeNode<LambdaTreeNode>(arrow, scope);
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 3);
 
@@ -41,7 +41,14 @@ namespace Martin {
 
     class GetterSetterTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Getter)
+                .Add(TokenType::Type::KW_Setter);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
 
             if (sym && (
@@ -51,14 +58,14 @@ namespace Martin {
                 TreeNode op;
 
                 if (sym->GetType() == TokenType::Type::KW_Getter)
-                    op = TreeNode(new GetterTreeNode);
+                    op = MakeTreeNode<GetterTreeNode>();
                 
                 else
-                    op = TreeNode(new SetterTreeNode);
+                    op = MakeTreeNode<SetterTreeNode>();
 
-                op->SetLineNumber(sym->GetLineNumber());
+                op->SetLocation(sym->GetLocation());
                 
-                TokenNode token_node = TokenNode(new TokenNodeBase);
+                TokenNode token_node = MakeTokenNode();
                 token_node->node = op;
                 ReplaceTreeWithTokenNode(tree, token_node, index, 1);
 
@@ -22,14 +22,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -83,26 +76,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -125,14 +100,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -186,26 +154,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         const TokenNode left;
@@ -228,14 +178,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!right) return false;
 
             if (!ValidateTokenNode(right)) return false;
@@ -288,18 +231,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(right);
         }
 
         const TokenNode right;
@@ -307,7 +240,15 @@ namespace Martin {
 
     class OPLogicalsTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_And)
+                .Add(TokenType::Type::KW_Or)
+                .Add(TokenType::Type::KW_Not);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_And) ||
@@ -318,19 +259,7 @@ namespace Martin {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    TreeNode op;
-
-                    if (sym->GetType() == TokenType::Type::KW_And)
-                        op = TreeNode(new OPLogicalAndTreeNode(left, right));
-                    
-                    else
-                        op = TreeNode(new OPLogicalOrTreeNode(left, right));
-                    
-                    op->SetLineNumber(sym->GetLineNumber());
-                    
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
+                    ReplaceTreeWithTokenNode(tree, Create(sym, left, right), index-1, 3);
 
                     return 3;
                 }
@@ -338,21 +267,38 @@ namespace Martin {
 
             return 0;
         }
+
+        static TokenNode Create(Token sym, TokenNode left, TokenNode right) {
+            TreeNode op;
+
+            if (sym->GetType() == TokenType::Type::KW_And)
+                op = MakeTreeNode<OPLogicalAndTreeNode>(left, right);
+            
+            else
+                op = MakeTreeNode<OPLogicalOrTreeNode>(left, right);
+            
+            op->SetLocation(sym->GetLocation());
+            
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
     };
 
     class OPNotLogicTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers.Add(TokenType::Type::KW_Not);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym &&  (sym->GetType() == TokenType::Type::KW_Not)) {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (right) {
-                    TreeNode op = TreeNode(new OPLogicalNotTreeNode(right));
-                    
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index, 2);
+                    ReplaceTreeWithTokenNode(tree, CreatePrefix(sym, right), index, 2);
 
                     return 2;
                 }
@@ -360,6 +306,14 @@ namespace Martin {
 
             return 0;
         }
+
+        static TokenNode CreatePrefix(Token sym, TokenNode right) {
+            TreeNode op = MakeTreeNode<OPLogicalNotTreeNode>(right);
+            
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
     };
 
 }
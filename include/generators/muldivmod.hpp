@@ -3,6 +3,8 @@
 
 #include <parse.hpp>
 
+#include "enclosures.hpp"
+
 namespace Martin {
 
     class OPMulTreeNode : public TreeNodeBase {
@@ -21,14 +23,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -37,26 +32,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         TokenNode left;
@@ -130,14 +107,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -146,26 +116,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         TokenNode left;
@@ -239,14 +191,7 @@ namespace Martin {
             serial = Format("$($, $)", GetName(), *left, *right);
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!left || !right) return false;
 
             if (!ValidateTokenNode(left)) return false;
@@ -255,26 +200,8 @@ namespace Martin {
             return true;
         }
 
-        std::vector<TreeNode> GetAllNodesOfType(Type type) const override {
-            std::vector<TreeNode> list;
-
-            if (!left->is_token) {
-                if (left->node->GetType() == type) {
-                    list.push_back(left->node);
-                }
-                auto list2 = left->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-            
-            if (!right->is_token) {
-                if (right->node->GetType() == type) {
-                    list.push_back(right->node);
-                }
-                auto list2 = right->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
-            }
-
-            return list;
+        bool VisitChildren(ChildVisitor& visit) const override {
+            return visit.Visit(left) && visit.Visit(right);
         }
 
         TokenNode left;
@@ -334,7 +261,15 @@ namespace Martin {
 
     class OPMulDivModTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::SYM_Mul)
+                .Add(TokenType::Type::SYM_Div)
+                .Add(TokenType::Type::SYM_Mod);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::SYM_Mul) ||
@@ -345,22 +280,7 @@ namespace Martin {
                 TokenNode right = GetIndexOrNull(tree, index+1);
 
                 if (left && right) {
-                    TreeNode op;
-                    
-                    if (sym->GetType() == TokenType::Type::SYM_Mul)
-                        op = TreeNode(new OPMulTreeNode(left, right));
-                    
-                    else if (sym->GetType() == TokenType::Type::SYM_Div)
-                        op = TreeNode(new OPDivTreeNode(left, right));
-                    
-                    else
-                        op = TreeNode(new OPModTreeNode(left, right));
-
-                    op->SetLineNumber(sym->GetLineNumber());
-                    
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
-                    token_node->node = op;
-                    ReplaceTreeWithTokenNode(tree, token_node, index-1, 3);
+                    ReplaceTreeWithTokenNode(tree, Create(sym, left, right), index-1, 3);
 
                     return 3;
                 }
@@ -368,6 +288,25 @@ namespace Martin {
 
             return 0;
         }
+
+        static TokenNode Create(Token sym, TokenNode left, TokenNode right) {
+            TreeNode op;
+            
+            if (sym->GetType() == TokenType::Type::SYM_Mul)
+                op = MakeTreeNode<OPMulTreeNode>(left, right);
+            
+            else if (sym->GetType() == TokenType::Type::SYM_Div)
+                op = MakeTreeNode<OPDivTreeNode>(left, right);
+            
+            else
+                op = MakeTreeNode<OPModTreeNode>(left, right);
+
+            op->SetLocation(sym->GetLocation());
+            
+            TokenNode token_node = MakeTokenNode();
+            token_node->node = op;
+            return token_node;
+        }
     };
 
 }
@@ -21,14 +21,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), id->GetName());
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!id) return false;
 
             if (id->GetType() != TokenType::Type::Identifier) return false;
@@ -55,14 +48,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), id->GetName());
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!id) return false;
 
             if (id->GetType() != TokenType::Type::Identifier) return false;
@@ -89,14 +75,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), id->GetName());
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!id) return false;
 
             if (id->GetType() != TokenType::Type::Identifier) return false;
@@ -123,14 +102,7 @@ namespace Martin {
             serial = Format("$($)", GetName(), id->GetName());
         }
 
-        bool Valid() const override {
-            if (!NodeValid()) {
-                Fatal("Node $ is invalid on line $\n", GetName(), GetLineNumber());
-            }
-            return true;
-        }
-
-        bool NodeValid() const {
+        bool CheckValid() const override {
             if (!id) return false;
 
             if (id->GetType() != TokenType::Type::Identifier) return false;
@@ -143,7 +115,16 @@ namespace Martin {
 
     class RetTypesTreeGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::KW_Let)
+                .Add(TokenType::Type::KW_Set)
+                .Add(TokenType::Type::KW_Const)
+                .Add(TokenType::Type::KW_Constexpr);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             if (sym && (
                 (sym->GetType() == TokenType::Type::KW_Let) ||
@@ -158,25 +139,25 @@ namespace Martin {
 
                     switch (sym->GetType()) {
                         case TokenType::Type::KW_Let:
-                            op = TreeNode(new LetRetTypeTreeNode(id));
+                            op = MakeTreeNode<LetRetTypeTreeNode>(id);
                             break;
                         
                         case TokenType::Type::KW_Set:
-                            op = TreeNode(new SetRetTypeTreeNode(id));
+                            op = MakeTreeNode<SetRetTypeTreeNode>(id);
                             break;
                         
                         case TokenType::Type::KW_Const:
-                            op = TreeNode(new ConstRetTypeTreeNode(id));
+                            op = MakeTreeNode<ConstRetTypeTreeNode>(id);
                             break;
                         
                         case TokenType::Type::KW_Constexpr:
-                            op = TreeNode(new ConstexprRetTypeTreeNode(id));
+                            op = MakeTreeNode<ConstexprRetTypeTreeNode>(id);
                             break;
                     }
 
-                    op->SetLineNumber(sym->GetLineNumber());
+                    op->SetLocation(sym->GetLocation());
 
-                    TokenNode token_node = TokenNode(new TokenNodeBase);
+                    TokenNode token_node = MakeTokenNode();
                     token_node->node = op;
                     ReplaceTreeWithTokenNode(tree, token_node, index, 2);
 
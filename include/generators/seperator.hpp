@@ -7,7 +7,15 @@ namespace Martin {
 
     class SeperatorGenerator : public TreeNodeGenerator {
     public:
-        size_t ProcessBranch(Tree tree, size_t index, size_t end) override {
+        bool GetTriggers(TriggerSet& triggers) const override {
+            triggers
+                .Add(TokenType::Type::Integer)
+                .Add(TokenType::Type::FloatingSingle)
+                .Add(TokenType::Type::FloatingDouble);
+            return true;
+        }
+
+        size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) override {
             Token sym = GetIndexOrNullToken(tree, index);
             Token last = GetIndexOrNullToken(tree, index-1);
             bool last_number = false;
@@ -24,20 +32,20 @@ namespace Martin {
                 (sym && (sym->GetType() == TokenType::Type::Integer)) &&
                 (last && last_number)
             ) {
-                auto ptr = std::static_pointer_cast<intmax_t>(sym->GetData());
+                intmax_t value = *std::static_pointer_cast<intmax_t>(sym->GetData());
 
-                if (*ptr < 0) {
-                    *ptr = -(*ptr);
+                if (value < 0) {
+                    value = -value;
                     
-                    auto num_tree = TokenizerSingleton.TokenizeString(std::to_string(*ptr));
-                    TokenNode num_node = TokenNode(new TokenNodeBase);
+                    auto num_tree = TokenizerSingleton.TokenizeString(std::to_string(value));
+                    TokenNode num_node = MakeTokenNode();
                     num_node->is_token = true;
                     num_node->token = (*num_tree)[0];
 
                     ReplaceTreeWithTokenNode(tree, num_node, index, 1);
 
                     auto neg_tree = TokenizerSingleton.TokenizeString("-");
-                    TokenNode node = TokenNode(new TokenNodeBase);
+                    TokenNode node = MakeTokenNode();
                     node->is_token = true;
                     node->token = (*neg_tree)[0];
                     tree->insert(tree->begin() + index, node);
@@ -46,20 +54,20 @@ namespace Martin {
                 (sym && (sym->GetType() == TokenType::Type::FloatingSingle)) &&
                 (last && last_number)
             ) {
-                auto ptr = std::static_pointer_cast<float>(sym->GetData());
+                float value = *std::static_pointer_cast<float>(sym->GetData());
 
-                if (*ptr < 0.0f) {
-                    *ptr = -(*ptr);
+                if (value < 0.0f) {
+                    value = -value;
                     
-                    auto num_tree = TokenizerSingleton.TokenizeString(std::to_string(*ptr) + "f");
-                    TokenNode num_node = TokenNode(new TokenNodeBase);
+                    auto num_tree = TokenizerSingleton.TokenizeString(std::to_string(value) + "f");
+                    TokenNode num_node = MakeTokenNode();
                     num_node->is_token = true;
                     num_node->token = (*num_tree)[0];
 
                     ReplaceTreeWithTokenNode(tree, num_node, index, 1);
 
                     auto neg_tree = TokenizerSingleton.TokenizeString("-");
-                    TokenNode node = TokenNode(new TokenNodeBase);
+                    TokenNode node = MakeTokenNode();
                     node->is_token = true;
                     node->token = (*neg_tree)[0];
                     tree->insert(tree->begin() + index, node);
@@ -68,20 +76,20 @@ namespace Martin {
                 (sym && (sym->GetType() == TokenType::Type::FloatingDouble)) &&
                 (last && last_number)
             ) {
-                auto ptr = std::static_pointer_cast<double>(sym->GetData());
+                double value = *std::static_pointer_cast<double>(sym->GetData());
 
-                if (*ptr < 0.0) {
-                    *ptr = -(*ptr);
+                if (value < 0.0) {
+                    value = -value;
                     
-                    auto num_tree = TokenizerSingleton.TokenizeString(std::to_string(*ptr));
-                    TokenNode num_node = TokenNode(new TokenNodeBase);
+                    auto num_tree = TokenizerSingleton.TokenizeString(std::to_string(value));
+                    TokenNode num_node = MakeTokenNode();
                     num_node->is_token = true;
                     num_node->token = (*num_tree)[0];
 
                     ReplaceTreeWithTokenNode(tree, num_node, index, 1);
 
                     auto neg_tree = TokenizerSingleton.TokenizeString("-");
-                    TokenNode node = TokenNode(new TokenNodeBase);
+                    TokenNode node = MakeTokenNode();
                     node->is_token = true;
                     node->token = (*neg_tree)[0];
                     tree->insert(tree->begin() + index, node);
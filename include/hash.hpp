@@ -0,0 +1,15 @@
+#ifndef MARTIN_HASH
+#define MARTIN_HASH
+
+#include <string_view>
+#include <stdint.h>
+
+namespace Martin {
+
+    // 64-bit content hash with the XXH64 algorithm, for telling whether data
+    // changed. Not meant to hold up against inputs built to collide
+    uint64_t Hash64(std::string_view data, uint64_t seed = 0);
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef MARTIN_INTERNER
+#define MARTIN_INTERNER
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+namespace Martin {
+
+    // Identifies one distinct spelling, equal spellings always get equal symbols
+    typedef uint32_t Symbol;
+
+    static const Symbol InvalidSymbol = UINT32_MAX;
+
+    // Maps spellings to symbols. Safe to use from any number of threads, the
+    // table is split into shards that each have their own lock
+    class Interner {
+    public:
+        typedef struct {
+            // Calls to Intern
+            size_t interned;
+            size_t unique;
+            // Bytes passed to Intern and bytes actually stored
+            size_t bytes_interned;
+            size_t bytes_stored;
+        } Stats;
+
+        Symbol Intern(std::string_view spelling);
+        // Symbol of a spelling that was already interned, InvalidSymbol otherwise
+        Symbol Find(std::string_view spelling) const;
+
+        // Null terminated, valid for the interner's lifetime
+        std::string_view GetSpelling(Symbol symbol) const;
+
+        Stats GetStats() const;
+
+    private:
+        static const size_t shard_bits = 4;
+        static const size_t shard_count = 1 << shard_bits;
+        static const size_t block_size = 1 << 16;
+
+        struct Shard {
+            mutable std::mutex mutex;
+
+            std::unordered_map<std::string_view, Symbol> symbols;
+            std::vector<std::string_view> spellings;
+
+            // Spellings are copied into blocks that never move
+            std::vector<std::unique_ptr<char[]>> blocks;
+            size_t block_used = block_size;
+            // Spellings bigger than a block get their own allocation
+            std::vector<std::unique_ptr<char[]>> large;
+
+            size_t interned = 0;
+            size_t bytes_interned = 0;
+            size_t bytes_stored = 0;
+        };
+
+        static size_t GetShard(std::string_view spelling);
+
+        Shard shards[shard_count];
+    };
+
+    extern Interner InternerSingleton;
+
+}
+
+#endif
@@ -2,12 +2,15 @@
 #define MARTIN_LAMBDA
 
 #include <parse.hpp>
+#include <flattree.hpp>
 #include <string>
 
 namespace Martin {
 
     void ResetLambdaCounter();
     void ProcessLambdas(Tree tree, const std::string& module_name);
+    // flat has to be a flattened tree, lambdas get added to tree
+    void ProcessLambdas(Tree tree, FlatTree flat, const std::string& module_name);
 
 }
 
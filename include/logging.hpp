@@ -78,7 +78,8 @@ namespace Martin {
         extern Logger* WarningLogger;
         extern Logger* PrintLogger;
 
-        extern Formatter* FormatFormatter;
+        // One per thread, Format can run on several at once
+        extern thread_local Formatter FormatFormatter;
 
         inline void FormatArr(std::vector<std::string>& arr) {}
 
@@ -96,13 +97,13 @@ namespace Martin {
         std::vector<std::string> strs;
         LoggingUtil::FormatArr(strs, first, rest...);
 
-        LoggingUtil::FormatFormatter->Clear();
+        LoggingUtil::FormatFormatter.Clear();
         for (auto str : strs) {
-            LoggingUtil::FormatFormatter->Push(str);
+            LoggingUtil::FormatFormatter.Push(str);
         }
 
         std::string result;
-        if (LoggingUtil::FormatFormatter->GetFormatted(result)) {
+        if (LoggingUtil::FormatFormatter.GetFormatted(result)) {
             return result;
         }
 
@@ -0,0 +1,30 @@
+#ifndef MARTIN_NUMBERS
+#define MARTIN_NUMBERS
+
+#include <string_view>
+#include <stdint.h>
+
+namespace Martin::Numbers {
+
+    enum class Result {
+        Ok,
+        // A character that isn't a digit of the radix or a separator
+        InvalidDigit,
+        // The value doesn't fit the target type
+        Overflow
+    };
+
+    // Digits of radix 2, 8, 10 or 16 with optional _ separators, into UIntMax
+    Result ParseUnsigned(std::string_view digits, unsigned int radix, uintmax_t& value);
+
+    // An optional -, then decimal digits with optional _ separators, into Int64
+    Result ParseSigned(std::string_view text, intmax_t& value);
+
+    // Most digits, leading zeros aside, a number of radix 2, 8, 10 or 16 can
+    // have and surely fit UIntMax, or Int64 when it's signed. Only longer
+    // ones need parsing to tell whether they overflow
+    size_t GetSafeDigits(unsigned int radix, bool is_signed = false);
+
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef MARTIN_PARALLEL
+#define MARTIN_PARALLEL
+
+#include <functional>
+#include <stddef.h>
+
+namespace Martin {
+
+    // Number of threads to use when the caller passes 0
+    size_t GetDefaultThreadCount();
+
+    // Calls func for every index in [0, count) on the calling thread and up to
+    // threads - 1 threads of a pool kept for the whole run, each taking the
+    // next unclaimed index, and returns once all calls are done. The first
+    // exception func throws stops the rest and is rethrown here
+    void ParallelFor(size_t count, const std::function<void(size_t)>& func, size_t threads = 0);
+
+}
+
+#endif
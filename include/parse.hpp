@@ -4,25 +4,48 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <bitset>
+#include <atomic>
 
 #include <tokens.hpp>
 #include <values.hpp>
 #include <logging.hpp>
+#include <tree.hpp>
+#include <arena.hpp>
 
 namespace Martin {
 
     class TreeNodeBase;
     class TreeNodeGenerator;
-
-    typedef struct _TokenNodeBase TokenNodeBase;
-
-    typedef std::shared_ptr<TokenNodeBase> TokenNode;
-    typedef std::shared_ptr<std::vector<TokenNode>> Tree;
+    class FlatTreeBase;
+    class ParseSession;
 
     typedef std::shared_ptr<TreeNodeBase> TreeNode;
 
     typedef std::shared_ptr<TreeNodeGenerator> TreeGenerator;
 
+    typedef std::shared_ptr<FlatTreeBase> FlatTree;
+
+    // Takes the items a node is made of one at a time, Visit returns false
+    // to stop
+    class ChildVisitor {
+    public:
+        virtual ~ChildVisitor() {}
+
+        virtual bool Visit(const TokenNode& child) = 0;
+
+        // false when one of the items stopped the visit
+        template <typename Items>
+        bool VisitAll(const Items& items) {
+            for (const TokenNode& item : items) {
+                if (!Visit(item))
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
     class TreeNodeBase {
     public:
         enum class Type {
@@ -116,35 +139,83 @@ namespace Martin {
             Misc_Setter
         };
 
+        // Number of types, Misc_Setter has to stay the last one
+        static const size_t TypeCount = (size_t)Type::Misc_Setter + 1;
+
         virtual ~TreeNodeBase() {}
         
         virtual Type GetType() const = 0;
         virtual std::string GetName() const = 0;
 
-        virtual void SetLineNumber(unsigned int lineno) {
-            if (this->lineno == 0) {
-                this->lineno = lineno;
+        // Nodes keep the first valid location they are given
+        void SetLocation(SourceLoc loc) {
+            if (!this->loc.IsValid()) {
+                this->loc = loc;
             }
         }
 
-        virtual unsigned int GetLineNumber() const {
-            return lineno;
+        SourceLoc GetLocation() const {
+            return loc;
+        }
+
+        // Both are 0 when there's no location or its source is gone
+        unsigned int GetLineNumber() const {
+            return GetLine(loc);
         };
 
+        unsigned int GetColumn() const {
+            return Martin::GetColumn(loc);
+        }
+
         virtual void Serialize(std::string& serial) const {
             serial = "Unimplemented serialize on tree node";
         }
 
-        virtual bool Valid() const {
+        // Whether the node and everything it checks below it are well formed.
+        // Nodes don't change once they're made, so the answer is worked out
+        // by CheckValid on the first call and stored for the ones after it,
+        // from generators, parents or Parser::FindInvalid alike
+        bool Valid() const;
+
+        // The node's own checks, calling Valid on the children it looks into
+        virtual bool CheckValid() const {
             return true;
         }
 
-        virtual std::vector<TreeNode> GetAllNodesOfType(Type type) const {
-            return {};
+        // Valid calls made, and the ones that had to run CheckValid, summed
+        // over all threads. Resetting while other threads parse loses counts
+        struct ValidCounters {
+            size_t calls = 0;
+            size_t checks = 0;
+        };
+
+        static ValidCounters GetValidCounters();
+        static void ResetValidCounters();
+
+        // Hands visit the items the node is made of, in order, nullptr for
+        // the missing ones. false when visit stopped it
+        virtual bool VisitChildren(ChildVisitor& visit) const {
+            return true;
         }
 
+        void GetChildren(std::vector<TokenNode>& children) const;
+
+        // Nodes of a type below this one, parents before their children.
+        // Like the node's fields they're only good while the node is, the
+        // Parser lookups give nodes that keep their arena alive
+        std::vector<TreeNode> GetAllNodesOfType(Type type) const;
+
     private:
-        unsigned int lineno = 0;
+        enum class Validity : uint8_t {
+            Unchecked,
+            Valid,
+            Invalid
+        };
+
+        SourceLoc loc;
+        // Threads racing on an unchecked node both run CheckValid and store
+        // the same answer
+        mutable std::atomic<Validity> validity { Validity::Unchecked };
     };
 
     struct _TokenNodeBase {
@@ -167,6 +238,146 @@ namespace Martin {
         bool is_token = false;
     };
 
+    enum class WalkOrder {
+        // Parents before their children
+        Preorder,
+        // Children before their parents
+        Postorder
+    };
+
+    // Calls visit on every item under the ones it's given, skipping the
+    // missing ones. The call stack is the only state, nothing is allocated
+    template <typename F>
+    class TreeWalker : public ChildVisitor {
+    public:
+        TreeWalker(F& visit, WalkOrder order) : visit(visit), order(order) {}
+
+        bool Visit(const TokenNode& item) override {
+            // Like types in "let a := 0"
+            if (!item || (item->is_token ? !item->token : !item->node))
+                return true;
+
+            if ((order == WalkOrder::Preorder) && !visit(item))
+                return false;
+
+            if (!item->is_token && !item->node->VisitChildren(*this))
+                return false;
+
+            return (order == WalkOrder::Postorder) ? visit(item) : true;
+        }
+
+    private:
+        F& visit;
+        WalkOrder order;
+    };
+
+    // Walks item and everything under it, calling visit(const TokenNode&)
+    // on tokens and nodes alike. visit returns false to end the walk early,
+    // Walk then returns false too
+    template <typename F>
+    bool Walk(const TokenNode& item, F visit, WalkOrder order = WalkOrder::Preorder) {
+        TreeWalker<F> walker(visit, order);
+        return walker.Visit(item);
+    }
+
+    template <typename F>
+    bool Walk(Tree tree, F visit, WalkOrder order = WalkOrder::Preorder) {
+        TreeWalker<F> walker(visit, order);
+        return walker.VisitAll(*tree);
+    }
+
+    // Nodes of a parse result by type, each list in the order
+    // GetAllNodesOfType gives them. Filled with one walk when the parse
+    // finishes, so lookups after it cost as much as what they find. The
+    // nodes keep the tree's arenas alive
+    class NodeIndexBase {
+    public:
+        NodeIndexBase() : lists(TreeNodeBase::TypeCount) {}
+        NodeIndexBase(Tree tree);
+
+        // Nodes of item and under it, after the ones already there. owner
+        // keeps them alive, see GetOwner
+        void Add(const TokenNode& item, const std::shared_ptr<const void>& owner);
+        // other's nodes after the ones already there
+        void Add(const NodeIndexBase& other);
+
+        const std::vector<TreeNode>& Get(TreeNodeBase::Type type) const {
+            return lists[(size_t)type];
+        }
+
+    private:
+        std::vector<std::vector<TreeNode>> lists;
+    };
+
+    // Nodes made during a parse go to its arena, the ones made outside of a
+    // parse are owned by their handles
+    template <typename T, typename... Args>
+    TreeNode MakeTreeNode(Args&&... args) {
+        if (AstArena* arena = AstArena::GetCurrent())
+            return arena->Make<T>(std::forward<Args>(args)...);
+
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+
+    inline TokenNode MakeTokenNode() {
+        if (AstArena* arena = AstArena::GetCurrent())
+            return arena->Make<TokenNodeBase>();
+
+        return std::make_shared<TokenNodeBase>();
+    }
+
+    // item, keeping owner alive while it's around. Handles that own what
+    // they point to already come back as they are, as do all of them when
+    // owner owns nothing
+    template <typename T, typename O>
+    std::shared_ptr<T> ShareOwnership(const std::shared_ptr<T>& item, const std::shared_ptr<O>& owner) {
+        if (!item || (item.use_count() != 0) || (owner.use_count() == 0))
+            return item;
+
+        return std::shared_ptr<T>(owner, item.get());
+    }
+
+    // What keeps item, one of tree's, and everything under it alive. Items
+    // at the top level of a parse result own their arena, the ones in the
+    // trees of nodes fall back on the tree's
+    inline std::shared_ptr<const void> GetOwner(const TreeBase& tree, const TokenNode& item) {
+        if (item.use_count() != 0)
+            return item;
+
+        return tree.GetArena();
+    }
+
+    // Kinds of items a generator can fire on
+    class TriggerSet {
+    public:
+        TriggerSet& Add(TokenType::Type type) {
+            tokens.set((size_t)type);
+            return *this;
+        }
+
+        TriggerSet& Add(TreeNodeBase::Type type) {
+            nodes.set((size_t)type);
+            return *this;
+        }
+
+        bool Matches(const TokenNode& item) const {
+            if (item->is_token)
+                return tokens.test((size_t)item->token->GetType());
+
+            return nodes.test((size_t)item->node->GetType());
+        }
+
+        // Whether anything in a branch holding the token kinds of present
+        // could fire. Nodes get made while a branch is parsed, so sets
+        // with node types always can
+        bool CanFire(const TriggerSet& present) const {
+            return nodes.any() || (tokens & present.tokens).any();
+        }
+
+    private:
+        std::bitset<TokenType::TypeCount> tokens;
+        std::bitset<TreeNodeBase::TypeCount> nodes;
+    };
 
     class TreeNodeGenerator {
     public:
@@ -176,7 +387,27 @@ namespace Martin {
             return false;
         }
 
-        virtual size_t ProcessBranch(Tree tree, size_t index, size_t end) = 0;
+        // Nested branches get parsed through session
+        virtual size_t ProcessBranch(ParseSession& session, Tree tree, size_t index, size_t end) = 0;
+
+        // Generators that only fire on a few kinds of items add them to
+        // triggers and return true, ParseBranch then skips every other item
+        // without calling ProcessBranch. The rest get called on every item
+        virtual bool GetTriggers(TriggerSet& triggers) const {
+            return false;
+        }
+
+        // Generators that rewrite the whole branch in a single call return
+        // true here, ParseBranch then calls ProcessRange once instead of
+        // ProcessBranch on every index
+        virtual bool IsRanged() const {
+            return false;
+        }
+
+        // Returns by how many items the branch shrank
+        virtual size_t ProcessRange(ParseSession& session, Tree tree, size_t start, size_t end) {
+            return 0;
+        }
 
         virtual void Serialize(std::string& serial) const {
             serial = "Unimplemented serialize on tree generator";
@@ -241,24 +472,119 @@ namespace Martin {
     class Parser {
     public:
         Parser();
+        // Runs the generators in the given order instead of the usual ones
+        Parser(const std::vector<TreeGenerator>& generators);
 
         Tree ParseFile(const std::string& path, std::string& error_msg);
         Tree ParseString(const std::string& code, std::string& error_msg);
 
         Tree ParseTokens(TokenList tokens);
+        Tree ParseTokens(TokenBuffer buffer);
+        // Builds the tree's token nodes while the stream is still lexing
+        Tree ParseTokens(TokenStream stream);
+
+        // Splits the tokens between top level declarations and parses the
+        // pieces on up to threads threads, giving the same tree as
+        // ParseTokens. Small files, and files whose pieces don't parse the
+        // way they would in one branch, are parsed serially
+        Tree ParseParallel(TokenList tokens, size_t threads = 0);
     
+        // Runs a session of its own, in the thread's current arena
         void ParseBranch(Tree tree, size_t start, size_t end);
 
         void Serialize(std::string& serial) const {
             serial = Format("Parser with $ generators", generators.size());
         }
 
+        // Warn about every token at the top level and every node FindInvalid
+        // finds, false when there was any
         static bool Valid(Tree tree);
-
+        static bool Valid(FlatTree tree);
+
+        // Where the problems of the top level nodes are. A valid node answers
+        // for everything under it, := takes a let without types for one, so
+        // only invalid nodes are followed down, to the ones whose children
+        // are all valid. In the order they appear in the tree, every node
+        // runs CheckValid at most once
+        static std::vector<TreeNode> FindInvalid(Tree tree);
+        static std::vector<TreeNode> FindInvalid(FlatTree tree);
+
+        // Looked up in the tree's node index when it has one. The nodes keep
+        // their arena alive, see GetOwner
         static std::vector<TreeNode> GetAllNodesOfType(Tree tree, TreeNodeBase::Type type);
 
+        // Adds item at the end of tree, keeping the tree's node index
+        static void Append(Tree tree, const TokenNode& item);
+
+        // ProcessBranch calls made, and the ones skipped because the item
+        // couldn't have fired the generator
+        struct Counters {
+            size_t calls = 0;
+            size_t avoided = 0;
+        };
+
+        Counters GetCounters() const;
+        void ResetCounters();
+
     private:
+        friend class ParseSession;
+
+        void SetTriggers();
+
+        // Neither changes after construction, generators keep no state
+        // between calls so sessions on any thread can share them
         std::vector<TreeGenerator> generators;
+        // Parallel to generators, nullptr for generators without triggers
+        std::vector<std::unique_ptr<TriggerSet>> triggers;
+
+        // Sessions add theirs when they end
+        mutable std::atomic<size_t> calls { 0 };
+        mutable std::atomic<size_t> avoided { 0 };
+    };
+
+    // State of one parse. Sessions share nothing that changes with each
+    // other, so parses with a session each can run on separate threads,
+    // with the same parser or different ones. Generators get the session
+    // they run in and parse nested branches through it
+    class ParseSession {
+    public:
+        // Nodes go to arena, or to the thread's current arena when it's nullptr
+        ParseSession(const Parser& parser, AstArena* arena = nullptr);
+        ~ParseSession();
+
+        ParseSession(const ParseSession&) = delete;
+        ParseSession& operator=(const ParseSession&) = delete;
+
+        void ParseBranch(Tree tree, size_t start, size_t end);
+
+        const Parser& GetParser() const {
+            return parser;
+        }
+
+        AstArena* GetArena() const {
+            return arena;
+        }
+
+        // Only this session's, the parser gets them when the session ends
+        const Parser::Counters& GetCounters() const {
+            return counters;
+        }
+
+        // Whether every pass over an outermost branch started and ended with
+        // end at the branch's size. Items a generator inserts or takes away
+        // without reporting it move end off the size, the passes after it
+        // then depend on everything before them in the branch
+        bool IsAligned() const {
+            return aligned;
+        }
+
+    private:
+        const Parser& parser;
+        AstArena* arena;
+        Parser::Counters counters;
+
+        size_t depth = 0;
+        bool aligned = true;
     };
 
     extern Parser ParserSingleton;
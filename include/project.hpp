@@ -11,6 +11,7 @@
 #include "config.hpp"
 #include "parse.hpp"
 #include "visibility.hpp"
+#include "tokencache.hpp"
 
 namespace Martin {
 
@@ -81,6 +82,9 @@ namespace Martin {
         const std::unordered_map<std::string, std::unique_ptr<Visibility>>& GetVisibility() const;
 
         void LoadProject(const std::string& starting_path);
+
+        // Reuses the tokens of unchanged files across loads, kept in directory
+        void SetTokenCache(const std::string& directory);
     private:
         void LoadPackages(const std::string& proj_src_dir);
 
@@ -89,6 +93,8 @@ namespace Martin {
         std::vector<std::unique_ptr<Package>> all_packages;
         std::unordered_map<std::string, Tree> files;
         std::unordered_map<std::string, std::unique_ptr<Visibility>> visibility;
+
+        std::unique_ptr<TokenCache> token_cache;
     };
 
 }
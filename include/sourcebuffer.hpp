@@ -0,0 +1,134 @@
+#ifndef MARTIN_SOURCEBUFFER
+#define MARTIN_SOURCEBUFFER
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Martin {
+
+    class SourceBufferBase;
+    typedef std::shared_ptr<SourceBufferBase> SourceBuffer;
+
+    // The low bits pick a live source's slot in the registry, the high bits
+    // are the slot's generation so locations into a freed source don't find
+    // the one that reuses its slot
+    typedef uint32_t FileID;
+
+    static const FileID InvalidFileID = UINT32_MAX;
+    static const unsigned int FileSlotBits = 20;
+
+    // A byte in a source. Lines and columns aren't stored, they come from the
+    // source's line table when they're asked for
+    struct SourceLoc {
+        FileID file = InvalidFileID;
+        uint32_t offset = 0;
+
+        bool IsValid() const { return file != InvalidFileID; }
+    };
+
+    static_assert(sizeof(SourceLoc) == 8, "SourceLoc should stay 8 bytes");
+
+    // 1 based line and column of loc, 0 when its source is gone
+    unsigned int GetLine(SourceLoc loc);
+    unsigned int GetColumn(SourceLoc loc);
+
+    // Read-only source text followed by at least `padding` zero bytes, so
+    // scanners can read past the end of a token without checking bounds
+    class SourceBufferBase : public std::enable_shared_from_this<SourceBufferBase> {
+    public:
+        static const size_t padding = 64;
+
+        ~SourceBufferBase();
+
+        // Maps regular files in place, pipes and other streams are read into
+        // a heap copy. A path of "-" reads stdin. Returns nullptr on failure
+        static SourceBuffer FromFile(const std::string& path, std::string& error_msg);
+        static SourceBuffer FromString(std::string_view code);
+        // Copy of source with removed bytes at offset replaced by inserted
+        static SourceBuffer FromEdit(const SourceBufferBase& source, size_t offset, size_t removed, std::string_view inserted);
+
+        const char* GetData() const { return data; }
+        size_t GetSize() const { return size; }
+        std::string_view GetView() const { return std::string_view(data, size); }
+
+        bool IsMapped() const { return mapped; }
+
+        FileID GetFileID() const { return id; }
+        SourceLoc GetLoc(size_t offset) const { return { id, (uint32_t)offset }; }
+
+        // 1 based, from a table of line starts built the first time either is used
+        unsigned int GetLine(size_t offset) const;
+        unsigned int GetColumn(size_t offset) const;
+
+        // nullptr once the source has been freed
+        static SourceBuffer FromFileID(FileID id);
+
+        // Calls use with the source of id while it can't be freed, false when
+        // it already has been. Doesn't lock, only the source's slot is touched
+        template <typename F>
+        static bool WithFileID(FileID id, F&& use);
+
+    private:
+        // A registry entry, a source freed while a lookup holds its slot waits
+        // for the lookup to finish
+        struct Slot {
+            std::atomic<const SourceBufferBase*> source { nullptr };
+            std::atomic<uint32_t> readers { 0 };
+            uint32_t generation = 0;
+        };
+
+        static std::atomic<Slot*> chunks[];
+
+        static Slot* GetSlot(FileID id);
+
+        SourceBufferBase() {}
+
+        // A new empty source with its file ID
+        static SourceBuffer Create();
+
+        const std::vector<uint32_t>& GetLineStarts() const;
+
+        bool ReadStream(int fd);
+
+        const char* data = nullptr;
+        size_t size = 0;
+
+        bool mapped = false;
+        void* mapping = nullptr;
+        size_t mapping_size = 0;
+
+        std::unique_ptr<char[]> heap;
+
+        FileID id = InvalidFileID;
+
+        mutable std::once_flag line_flag;
+        mutable std::vector<uint32_t> line_starts;
+    };
+
+    template <typename F>
+    bool SourceBufferBase::WithFileID(FileID id, F&& use) {
+        Slot* slot = GetSlot(id);
+        if (!slot)
+            return false;
+
+        // Pairs with the destructor clearing the slot before it checks for readers
+        slot->readers.fetch_add(1);
+        const SourceBufferBase* source = slot->source.load();
+        bool found = source && (source->id == id);
+
+        if (found)
+            use(*source);
+
+        slot->readers.fetch_sub(1);
+        return found;
+    }
+
+}
+
+#endif
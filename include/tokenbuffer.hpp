@@ -0,0 +1,110 @@
+#ifndef MARTIN_TOKENBUFFER
+#define MARTIN_TOKENBUFFER
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "tokens.hpp"
+#include "sourcebuffer.hpp"
+#include "interner.hpp"
+
+namespace Martin {
+
+    struct TokenRecord {
+        // Start of the token's span in the source
+        uint32_t offset;
+        // Number of source bytes the token spans
+        uint32_t length;
+        // Symbol of identifiers, the value itself for booleans and the
+        // literal slot of numbers and strings
+        uint32_t payload;
+        // TokenType::Type of the token
+        uint32_t kind;
+    };
+
+    static_assert(sizeof(TokenRecord) == 16, "TokenRecord should stay 16 bytes");
+
+    typedef union {
+        uintmax_t uinteger;
+        intmax_t integer;
+        float single;
+        double floating;
+    } TokenValue;
+
+    class TokenBufferBase {
+    public:
+        TokenBufferBase(SourceBuffer source) : source(source) {}
+
+        size_t Size() const { return records.size(); }
+
+        const TokenRecord& GetRecord(size_t index) const { return records[index]; }
+        TokenType::Type GetType(size_t index) const { return (TokenType::Type)records[index].kind; }
+        SourceLoc GetLocation(size_t index) const { return source->GetLoc(records[index].offset); }
+        unsigned int GetLineNumber(size_t index) const { return source->GetLine(records[index].offset); }
+        unsigned int GetColumn(size_t index) const { return source->GetColumn(records[index].offset); }
+
+        std::string_view GetSource() const { return source->GetView(); }
+        SourceBuffer GetSourceBuffer() const { return source; }
+        std::string_view GetSpan(size_t index) const;
+
+        // Literals are decoded from their span the first time one of these
+        // asks for them, and the result is kept for later calls
+        const TokenValue& GetValue(size_t index) const;
+        // Null terminated bytes of string literals and identifiers
+        const uint8_t* GetBytes(size_t index) const;
+        // InvalidSymbol for kinds that aren't interned
+        Symbol GetSymbol(size_t index) const;
+
+        std::string GetName(size_t index) const;
+
+        void Reserve(size_t count);
+        void Push(const TokenRecord& record);
+        void Push(const TokenRecord* records, size_t count);
+
+        // Moves other's records to the end of this buffer, they have to
+        // share the same source
+        void Append(TokenBufferBase& other);
+
+        // Copies other's records from begin to end onto this buffer, moving
+        // their offsets by shift. Decoded numbers and 8 bit strings come
+        // along, wider strings decode again on access
+        void AppendShifted(const TokenBufferBase& other, size_t begin, size_t end, ptrdiff_t shift);
+
+        // Slot for a number or string literal that gets decoded on access
+        uint32_t AddLiteral();
+        // Slot for a number literal that has been decoded already
+        uint32_t AddLiteral(const TokenValue& value);
+        void ReserveLiterals(size_t count);
+
+    private:
+        struct Literal {
+            bool decoded = false;
+
+            TokenValue value;
+            // 8 bit strings
+            Symbol symbol = InvalidSymbol;
+            // Wider strings, terminated by a zero unit
+            std::unique_ptr<uint8_t[]> bytes;
+        };
+
+        const Literal& GetLiteral(size_t index) const;
+
+        SourceBuffer source;
+
+        std::vector<TokenRecord> records;
+
+        mutable std::vector<Literal> literals;
+        mutable std::mutex literal_mutex;
+    };
+
+    // Builds TokenType views over every record, sharing ownership of the buffer
+    TokenList CreateTokenList(TokenBuffer buffer);
+
+}
+
+#endif
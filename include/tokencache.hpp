@@ -0,0 +1,44 @@
+#ifndef MARTIN_TOKENCACHE
+#define MARTIN_TOKENCACHE
+
+#include <string>
+#include <string_view>
+#include <stdint.h>
+
+#include "tokens.hpp"
+#include "sourcebuffer.hpp"
+
+namespace Martin {
+
+    // Keeps the tokens of sources in a directory, one entry per distinct
+    // content. Entries hold the token records, decoded number literals and
+    // identifier spellings, strings are decoded from the source again on
+    // access. Entries of another compiler version are never used
+    class TokenCache {
+    public:
+        // Bump when the entry layout, TokenRecord or the token kinds change
+        static const uint32_t format = 3;
+
+        // The directory gets created when it doesn't exist
+        TokenCache(const std::string& directory);
+
+        // Tokens of source from its entry, lexing and storing them when there is none
+        TokenBuffer Tokenize(SourceBuffer source);
+
+        // nullptr when there's no usable entry for source
+        TokenBuffer Load(SourceBuffer source) const;
+        bool Store(const TokenBufferBase& buffer) const;
+
+        // Content hash of source, seeded with the format and compiler version
+        static uint64_t GetKey(std::string_view source);
+        std::string GetEntryPath(uint64_t key) const;
+
+        const std::string& GetDirectory() const { return directory; }
+
+    private:
+        std::string directory;
+    };
+
+}
+
+#endif
@@ -2,11 +2,24 @@
 #define MARTIN_TOKENS
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <stdint.h>
+
+#include "sourcebuffer.hpp"
+#include "interner.hpp"
 
 namespace Martin {
 
+    struct TokenRecord;
+    class TokenBufferBase;
+
+    typedef std::shared_ptr<TokenBufferBase> TokenBuffer;
+
+    class TokenStreamBase;
+    typedef std::shared_ptr<TokenStreamBase> TokenStream;
+
     class TokenType {
     public:
         enum class Type {
@@ -114,11 +127,13 @@ namespace Martin {
             SYM_GreaterThan
         };
 
+        // Number of kinds, SYM_GreaterThan has to stay the last one
+        static const size_t TypeCount = (size_t)Type::SYM_GreaterThan + 1;
+
         virtual ~TokenType() {};
         
         virtual Type GetType() const = 0;
 
-        virtual void Process(std::string& in) = 0;
         virtual std::shared_ptr<void> GetData() {
             return nullptr;
         };
@@ -127,14 +142,54 @@ namespace Martin {
             return "Unknown";
         }
 
-        void SetLineNumber(unsigned int number) { if (lineno == 0) lineno = number; }
-        unsigned int GetLineNumber() const { return lineno; }
+        // Interned spelling of identifiers and 8 bit strings, compare these
+        // instead of the bytes from GetData
+        virtual Symbol GetSymbol() const {
+            return InvalidSymbol;
+        }
+
+        // Where the token starts and how many bytes of the source it spans
+        void SetLocation(SourceLoc loc, size_t length) { this->loc = loc; this->length = (uint32_t)length; }
+        SourceLoc GetLocation() const { return loc; }
+
+        unsigned int GetLineNumber() const { return GetLine(loc); }
+        unsigned int GetColumn() const { return Martin::GetColumn(loc); }
+
+        // [begin, end) offsets of the token inside the tokenized source
+        size_t GetBegin() const { return loc.offset; }
+        size_t GetEnd() const { return (size_t)loc.offset + length; }
     private:
-        unsigned int lineno = 0;
+        SourceLoc loc;
+        uint32_t length = 0;
     };
 
     typedef std::shared_ptr<TokenType> Token;
 
+    // Where a tokenizer run currently is in its source. Every run owns one,
+    // so tokenizing different sources on different threads never shares it.
+    // Lines aren't tracked, the source works them out from offsets
+    class LexerState {
+    public:
+        // Wrong with a token a pattern read, the tokenizer reports it
+        enum class Problem {
+            None,
+            // A number literal's value doesn't fit its type
+            Overflow
+        };
+
+        LexerState(size_t position = 0) : position(position) {}
+
+        size_t GetPosition() const { return position; }
+        void Advance(size_t length) { position += length; }
+
+        Problem GetProblem() const { return problem; }
+        void SetProblem(Problem problem) { this->problem = problem; }
+
+    private:
+        size_t position = 0;
+        Problem problem = Problem::None;
+    };
+
     class PatternType {
     public:
         virtual ~PatternType() {};
@@ -143,8 +198,21 @@ namespace Martin {
             UInteger
         };
 
-        virtual bool IsMatch(const std::string& in) const = 0;
-        virtual Token CreateToken() const = 0;
+        virtual bool IsMatch(std::string_view in) const = 0;
+
+        // Reads the token at the front of in into record, storing any value in
+        // the buffer's side tables, and returns how many bytes it spans
+        virtual size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const = 0;
+
+        // Whether a match can begin with c, used to build the tokenizer's dispatch table
+        virtual bool CanStartWith(char c) const {
+            return true;
+        }
+
+        // Spelling of keyword and symbol patterns, nullptr for everything else
+        virtual const char* GetFixed() const {
+            return nullptr;
+        }
     };
 
     typedef std::shared_ptr<PatternType> Pattern;
@@ -152,12 +220,60 @@ namespace Martin {
     
     class Tokenizer {
     public:
-        Tokenizer();
+        enum class Matching {
+            // Tries every pattern in registration order
+            PatternChain,
+            // Jumps on the first byte and matches keywords and symbols with a DFA
+            DispatchTable
+        };
+
+        Tokenizer(Matching matching = Matching::DispatchTable);
+
+        TokenBuffer TokenizeBuffer(std::string_view input);
+        // Lexes the source in place, the buffer keeps it alive
+        TokenBuffer TokenizeBuffer(SourceBuffer input);
+        TokenList TokenizeString(std::string_view input);
 
-        TokenList TokenizeString(std::string input);
+        // Splits the source at newlines outside comments and strings and lexes
+        // the chunks on up to threads threads, giving the same buffer as
+        // TokenizeBuffer. Small sources are lexed serially
+        TokenBuffer TokenizeParallel(SourceBuffer input, size_t threads = 0);
+
+        // Lexes previous's source with removed bytes at offset replaced by
+        // inserted. Only the tokens around the edit are lexed again, the ones
+        // after it are copied over with their offsets shifted
+        TokenBuffer Relex(TokenBuffer previous, size_t offset, size_t removed, std::string_view inserted);
+
+        // Lexes up to count tokens from the state's position into a new buffer
+        // over input, for going through a source a piece at a time
+        TokenBuffer TokenizeBlock(SourceBuffer input, LexerState& state, size_t count);
 
     private:
+        // Lexes from the state's position until end, which has to be a token boundary
+        void Lex(TokenBufferBase& buffer, LexerState& state, size_t end) const;
+        // Lexes the single token at the state's position
+        void Step(TokenBufferBase& buffer, LexerState& state) const;
+
+        const PatternType* FindPattern(std::string_view in) const;
+        const PatternType* FindFixedPattern(std::string_view in) const;
+
+        void BuildDispatchTable();
+
+        Matching matching;
+
         std::vector<Pattern> patterns;
+
+        // Candidate patterns for each first byte in registration order, a
+        // nullptr entry is where the fixed token DFA gets consulted
+        std::vector<Pattern> dispatch[256];
+
+        // Longest match DFA over every fixed spelling. State 0 is dead and
+        // state 1 is the start, transitions are indexed by byte class
+        uint8_t byte_classes[256] = {};
+        size_t class_count = 1;
+        size_t longest_fixed = 0;
+        std::vector<uint16_t> transitions;
+        std::vector<Pattern> accepts;
     };
 
     extern Tokenizer TokenizerSingleton;
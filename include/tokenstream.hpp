@@ -0,0 +1,65 @@
+#ifndef MARTIN_TOKENSTREAM
+#define MARTIN_TOKENSTREAM
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "tokens.hpp"
+#include "sourcebuffer.hpp"
+
+namespace Martin {
+
+    // Hands out the tokens of a source one at a time, lexing them in blocks
+    // into a ring of at most capacity tokens. Blocks are freed once the
+    // tokens taken from them are, so a reader that doesn't keep its tokens
+    // around runs in memory bounded by the capacity. Meant for one reader
+    class TokenStreamBase {
+    public:
+        // A pipelined stream lexes on its own thread while the tokens are
+        // being read, otherwise the reader lexes the next block when it runs out
+        TokenStreamBase(SourceBuffer source, size_t capacity = 1 << 14, bool pipelined = true);
+        ~TokenStreamBase();
+
+        TokenStreamBase(const TokenStreamBase&) = delete;
+        TokenStreamBase& operator=(const TokenStreamBase&) = delete;
+
+        // The token ahead tokens past the next one, nullptr past the end.
+        // Looking ahead is limited to half the capacity
+        Token Peek(size_t ahead = 0);
+        // Takes the next token, nullptr at the end
+        Token Next();
+
+        size_t GetCapacity() const { return capacity; }
+
+    private:
+        // Lexes the next block and adds it to the ring, false once the source is done
+        bool Fill();
+        // Waits until the ring holds more than ahead tokens or the source is done
+        bool Wait(std::unique_lock<std::mutex>& lock, size_t ahead);
+
+        SourceBuffer source;
+        LexerState state;
+
+        size_t capacity;
+        size_t block;
+
+        std::vector<Token> ring;
+        size_t head = 0;
+        size_t count = 0;
+
+        bool pipelined;
+        bool done = false;
+        bool stopping = false;
+
+        std::mutex mutex;
+        std::condition_variable readable;
+        std::condition_variable writable;
+        std::thread producer;
+    };
+
+}
+
+#endif
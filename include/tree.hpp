@@ -0,0 +1,223 @@
+#ifndef MARTIN_TREE
+#define MARTIN_TREE
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stddef.h>
+
+#include <arena.hpp>
+
+namespace Martin {
+
+    typedef struct _TokenNodeBase TokenNodeBase;
+    typedef std::shared_ptr<TokenNodeBase> TokenNode;
+
+    class TreeBase;
+    typedef std::shared_ptr<TreeBase> Tree;
+
+    class NodeIndexBase;
+    typedef std::shared_ptr<NodeIndexBase> NodeIndex;
+
+    // Sequence of token nodes that generators reduce in place. It's a gap
+    // buffer: the free space sits where the last insert or erase happened,
+    // so reductions next to each other cost as much as the items they
+    // touch rather than moving the whole tail. Indexing stays constant time
+    class TreeBase {
+    public:
+        template <typename Owner, typename Value>
+        class Iterator {
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef TokenNode value_type;
+            typedef ptrdiff_t difference_type;
+            typedef Value* pointer;
+            typedef Value& reference;
+
+            Iterator() {}
+            Iterator(Owner* tree, size_t index) : tree(tree), index(index) {}
+
+            reference operator*() const { return (*tree)[index]; }
+            pointer operator->() const { return &(*tree)[index]; }
+            reference operator[](difference_type n) const { return (*tree)[index + n]; }
+
+            Iterator& operator++() { index++; return *this; }
+            Iterator& operator--() { index--; return *this; }
+            Iterator operator++(int) { Iterator old = *this; index++; return old; }
+            Iterator operator--(int) { Iterator old = *this; index--; return old; }
+
+            Iterator& operator+=(difference_type n) { index += n; return *this; }
+            Iterator& operator-=(difference_type n) { index -= n; return *this; }
+            Iterator operator+(difference_type n) const { return Iterator(tree, index + n); }
+            Iterator operator-(difference_type n) const { return Iterator(tree, index - n); }
+            difference_type operator-(const Iterator& other) const { return (difference_type)index - (difference_type)other.index; }
+
+            bool operator==(const Iterator& other) const { return index == other.index; }
+            bool operator!=(const Iterator& other) const { return index != other.index; }
+            bool operator<(const Iterator& other) const { return index < other.index; }
+            bool operator>(const Iterator& other) const { return index > other.index; }
+            bool operator<=(const Iterator& other) const { return index <= other.index; }
+            bool operator>=(const Iterator& other) const { return index >= other.index; }
+
+            size_t GetIndex() const { return index; }
+
+        private:
+            Owner* tree = nullptr;
+            size_t index = 0;
+        };
+
+        typedef Iterator<TreeBase, TokenNode> iterator;
+        typedef Iterator<const TreeBase, const TokenNode> const_iterator;
+
+        // Trees made during a parse remember its arena
+        TreeBase() {
+            if (AstArena* current = AstArena::GetCurrent())
+                arena = current->weak_from_this();
+        }
+
+        size_t size() const { return items.size() - (gap_end - gap_begin); }
+        bool empty() const { return size() == 0; }
+
+        TokenNode& operator[](size_t index) { return items[GetSlot(index)]; }
+        const TokenNode& operator[](size_t index) const { return items[GetSlot(index)]; }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+        // Nodes of the tree by type, trees a parse gives back have one.
+        // Adding or taking away items drops it, replacing them through
+        // operator[] goes unnoticed
+        const NodeIndex& GetIndex() const {
+            return node_index;
+        }
+
+        void SetIndex(NodeIndex index) {
+            node_index = index;
+        }
+
+        // Arena the tree was made in, nullptr when it wasn't made in one
+        // owned by a shared_ptr or the arena is gone. Only a weak reference
+        // is kept, trees inside nodes live in the arena they point to
+        std::shared_ptr<AstArena> GetArena() const {
+            return arena.lock();
+        }
+
+        void reserve(size_t count) {
+            if (count > size())
+                Grow(count - size());
+        }
+
+        void push_back(const TokenNode& node) {
+            Insert(size(), node);
+        }
+
+        iterator insert(iterator pos, const TokenNode& node) {
+            Insert(pos.GetIndex(), node);
+            return pos;
+        }
+
+        // first and last can't point into this tree
+        template <typename InputIt>
+        iterator insert(iterator pos, InputIt first, InputIt last) {
+            size_t index = pos.GetIndex();
+
+            node_index.reset();
+            MoveGap(index);
+            for (; first != last; ++first) {
+                if (gap_begin == gap_end)
+                    Grow(1);
+
+                items[gap_begin++] = *first;
+            }
+
+            return pos;
+        }
+
+        iterator erase(iterator pos) {
+            return erase(pos, pos + 1);
+        }
+
+        iterator erase(iterator first, iterator last) {
+            size_t index = first.GetIndex();
+            size_t count = last.GetIndex() - index;
+
+            node_index.reset();
+            MoveGap(index);
+            for (size_t i = 0; i < count; i++)
+                items[gap_end + i].reset();
+            gap_end += count;
+
+            return first;
+        }
+
+        void clear() {
+            items.clear();
+            gap_begin = gap_end = 0;
+            node_index.reset();
+        }
+
+        void swap(TreeBase& other) {
+            items.swap(other.items);
+            std::swap(gap_begin, other.gap_begin);
+            std::swap(gap_end, other.gap_end);
+            node_index.swap(other.node_index);
+            arena.swap(other.arena);
+        }
+
+    private:
+        size_t GetSlot(size_t index) const {
+            return (index < gap_begin) ? index : index + (gap_end - gap_begin);
+        }
+
+        void Insert(size_t index, const TokenNode& node) {
+            node_index.reset();
+            MoveGap(index);
+            if (gap_begin == gap_end)
+                Grow(1);
+
+            items[gap_begin++] = node;
+        }
+
+        // Moves the free space so it starts right before index
+        void MoveGap(size_t index) {
+            if (index < gap_begin) {
+                size_t count = gap_begin - index;
+                std::move_backward(items.begin() + index, items.begin() + gap_begin, items.begin() + gap_end);
+                gap_begin -= count;
+                gap_end -= count;
+            } else if (index > gap_begin) {
+                size_t count = index - gap_begin;
+                std::move(items.begin() + gap_end, items.begin() + gap_end + count, items.begin() + gap_begin);
+                gap_begin += count;
+                gap_end += count;
+            }
+        }
+
+        // Makes room for at least count more items, keeping the gap where it is
+        void Grow(size_t count) {
+            size_t used = size();
+            size_t capacity = std::max(std::max(items.size() * 2, used + count), (size_t)16);
+
+            std::vector<TokenNode> grown(capacity);
+            std::move(items.begin(), items.begin() + gap_begin, grown.begin());
+            std::move(items.begin() + gap_end, items.end(), grown.end() - (items.size() - gap_end));
+
+            gap_end = capacity - (items.size() - gap_end);
+            items.swap(grown);
+        }
+
+        // Slots in [gap_begin, gap_end) are always empty
+        std::vector<TokenNode> items;
+        size_t gap_begin = 0;
+        size_t gap_end = 0;
+
+        NodeIndex node_index;
+        std::weak_ptr<AstArena> arena;
+    };
+
+}
+
+#endif
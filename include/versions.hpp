@@ -17,6 +17,9 @@ namespace Martin {
         uint32_t patch = 0;
         Level level = Level::Release;
     } Version;
+
+    // Version of the compiler itself, anything it caches is tied to it
+    static const Version CompilerVersion = { 0, 1, 0, Version::Level::Alpha };
 }
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define MARTIN_VISIBILITY
 
 #include "parse.hpp"
+#include "flattree.hpp"
 
 #include <vector>
 #include <string>
@@ -15,6 +16,7 @@ namespace Martin {
         } VisibilityNode;
 
         Visibility(Tree tree);
+        Visibility(FlatTree tree);
 
         const std::vector<VisibilityNode> GetFunctions(const std::string& name = "") const;
         const std::vector<VisibilityNode> GetTypes(const std::string& name = "") const;
@@ -22,6 +24,13 @@ namespace Martin {
         const std::vector<VisibilityNode> GetClasses(const std::string& name = "") const;
         const std::vector<VisibilityNode> GetImports(const std::string& name = "") const;
 
+        // Exact matches, compared by symbol
+        const std::vector<VisibilityNode> GetFunctions(Symbol name) const;
+        const std::vector<VisibilityNode> GetTypes(Symbol name) const;
+        const std::vector<VisibilityNode> GetVariables(Symbol name) const;
+        const std::vector<VisibilityNode> GetClasses(Symbol name) const;
+        const std::vector<VisibilityNode> GetImports(Symbol name) const;
+
     private:
         std::vector<VisibilityNode> functions;
         std::vector<VisibilityNode> types;
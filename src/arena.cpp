@@ -0,0 +1,58 @@
+#include <arena.hpp>
+#include <logging.hpp>
+
+#include <cstddef>
+
+namespace Martin {
+
+    static thread_local AstArena* current_arena = nullptr;
+
+    AstArena::~AstArena() {
+        // Handles between objects don't own anything, so the order only
+        // matters to objects that point at each other in their destructors
+        for (size_t i = objects.size(); i > 0; i--)
+            objects[i-1].destroy(objects[i-1].object);
+    }
+
+    void* AstArena::Allocate(size_t size, size_t align) {
+        if (align > alignof(std::max_align_t))
+            Fatal("Can't place an object aligned to $ bytes in an arena\n", align);
+
+        bytes += size;
+
+        if (size > block_size) {
+            large.push_back(std::unique_ptr<char[]>(new char[size]));
+            return large.back().get();
+        }
+
+        size_t offset = (block_used + align - 1) & ~(align - 1);
+        if (offset + size > block_size) {
+            blocks.push_back(std::unique_ptr<char[]>(new char[block_size]));
+            offset = 0;
+        }
+
+        block_used = offset + size;
+        return blocks.back().get() + offset;
+    }
+
+    AstArena::Stats AstArena::GetStats() const {
+        Stats stats;
+        stats.objects = objects.size();
+        stats.blocks = blocks.size() + large.size();
+        stats.bytes = bytes;
+        return stats;
+    }
+
+    AstArena* AstArena::GetCurrent() {
+        return current_arena;
+    }
+
+    AstArena::Scope::Scope(AstArena* arena) : previous(current_arena) {
+        current_arena = arena;
+    }
+
+    AstArena::Scope::~Scope() {
+        current_arena = previous;
+    }
+
+}
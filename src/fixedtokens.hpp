@@ -0,0 +1,95 @@
+#ifndef MARTIN_FIXEDTOKENS
+#define MARTIN_FIXEDTOKENS
+
+// Keyword and symbol spellings in the order the tokenizer tries them. A
+// symbol that is a prefix of another has to come after the longer one
+#define MARTIN_FIXED_TOKENS(KW, SYM)\
+    KW(KWFromPattern, KW_From, "from")\
+    KW(KWImportPattern, KW_Import, "import")\
+    KW(KWAsPattern, KW_As, "as")\
+    KW(KWInPattern, KW_In, "in")\
+    KW(KWStructPattern, KW_Struct, "struct")\
+    KW(KWUnionPattern, KW_Union, "union")\
+    KW(KWEnumPattern, KW_Enum, "enum")\
+    KW(KWTypedefPattern, KW_Typedef, "typedef")\
+    KW(KWLetPattern, KW_Let, "let")\
+    KW(KWSetPattern, KW_Set, "set")\
+    KW(KWConstPattern, KW_Const, "const")\
+    KW(KWConstexprPattern, KW_Constexpr, "constexpr")\
+    KW(KWReferencePattern, KW_Reference, "reference")\
+    KW(KWSharedPattern, KW_Shared, "shared")\
+    KW(KWUniquePattern, KW_Unique, "unique")\
+    KW(KWPointerPattern, KW_Pointer, "pointer")\
+    KW(KWExternPattern, KW_Extern, "extern")\
+    KW(KWUnsafePattern, KW_Unsafe, "unsafe")\
+    KW(KWFuncPattern, KW_Func, "func")\
+    KW(KWClassPattern, KW_Class, "class")\
+    KW(KWPublicPattern, KW_Public, "public")\
+    KW(KWProtectedPattern, KW_Protected, "protected")\
+    KW(KWPrivatePattern, KW_Private, "private")\
+    KW(KWFriendPattern, KW_Friend, "friend")\
+    KW(KWVirtualPattern, KW_Virtual, "virtual")\
+    KW(KWOverridePattern, KW_Override, "override")\
+    KW(KWStaticPattern, KW_Static, "static")\
+    KW(KWGetterPattern, KW_Getter, "getter")\
+    KW(KWSetterPattern, KW_Setter, "setter")\
+    KW(KWIfPattern, KW_If, "if")\
+    KW(KWElifPattern, KW_Elif, "elif")\
+    KW(KWElsePattern, KW_Else, "else")\
+    KW(KWForeachPattern, KW_Foreach, "foreach")\
+    KW(KWForPattern, KW_For, "for")\
+    KW(KWWhilePattern, KW_While, "while")\
+    KW(KWContinuePattern, KW_Continue, "continue")\
+    KW(KWBreakPattern, KW_Break, "break")\
+    KW(KWMatchPattern, KW_Match, "match")\
+    KW(KWSwitchPattern, KW_Switch, "switch")\
+    KW(KWReturnPattern, KW_Return, "return")\
+    KW(KWLambdaPattern, KW_Lambda, "lambda")\
+    KW(KWAndPattern, KW_And, "and")\
+    KW(KWOrPattern, KW_Or, "or")\
+    KW(KWNotPattern, KW_Not, "not")\
+    SYM(SYMCommaPattern, SYM_Comma, ",")\
+    SYM(SYMPeriodPattern, SYM_Period, ".")\
+    SYM(SYMOpenCurlyPattern, SYM_OpenCurly, "{")\
+    SYM(SYMCloseCurlyPattern, SYM_CloseCurly, "}")\
+    SYM(SYMOpenBracketPattern, SYM_OpenBracket, "[")\
+    SYM(SYMCloseBracketPattern, SYM_CloseBracket, "]")\
+    SYM(SYMOpenParenthesesPattern, SYM_OpenParentheses, "(")\
+    SYM(SYMCloseParenthesesPattern, SYM_CloseParentheses, ")")\
+    SYM(SYMSemiColonPattern, SYM_SemiColon, ";")\
+    SYM(SYMTypeAssignPattern, SYM_TypeAssign, ":=")\
+    SYM(SYMColonPattern, SYM_Colon, ":")\
+    SYM(SYMArrowPattern, SYM_Arrow, "->")\
+    SYM(SYMAssignAddPattern, SYM_AssignAdd, "+=")\
+    SYM(SYMAssignSubPattern, SYM_AssignSub, "-=")\
+    SYM(SYMAssignMulPattern, SYM_AssignMul, "*=")\
+    SYM(SYMAssignDivPattern, SYM_AssignDiv, "/=")\
+    SYM(SYMAssignModPattern, SYM_AssignMod, "%=")\
+    SYM(SYMAssignPowPattern, SYM_AssignPow, "**=")\
+    SYM(SYMAssignBitAndPattern, SYM_AssignBitAnd, "&=")\
+    SYM(SYMAssignBitOrPattern, SYM_AssignBitOr, "|=")\
+    SYM(SYMAssignBitXOrPattern, SYM_AssignBitXOr, "^=")\
+    SYM(SYMAssignBitNotPattern, SYM_AssignBitNot, "~=")\
+    SYM(SYMAssignBitShiftLeftPattern, SYM_AssignBitShiftLeft, "<<=")\
+    SYM(SYMAssignBitShiftRightPattern, SYM_AssignBitShiftRight, ">>=")\
+    SYM(SYMAddPattern, SYM_Add, "+")\
+    SYM(SYMSubPattern, SYM_Sub, "-")\
+    SYM(SYMPowPattern, SYM_Pow, "**")\
+    SYM(SYMMulPattern, SYM_Mul, "*")\
+    SYM(SYMDivPattern, SYM_Div, "/")\
+    SYM(SYMModPattern, SYM_Mod, "%")\
+    SYM(SYMBitAndPattern, SYM_BitAnd, "&")\
+    SYM(SYMBitOrPattern, SYM_BitOr, "|")\
+    SYM(SYMBitXOrPattern, SYM_BitXOr, "^")\
+    SYM(SYMBitNotPattern, SYM_BitNot, "~")\
+    SYM(SYMBitShiftLeftPattern, SYM_BitShiftLeft, "<<")\
+    SYM(SYMBitShiftRightPattern, SYM_BitShiftRight, ">>")\
+    SYM(SYMEqualsPattern, SYM_Equals, "==")\
+    SYM(SYMNotEqualsPattern, SYM_NotEquals, "!=")\
+    SYM(SYMLessThanEqualsPattern, SYM_LessThanEquals, "<=")\
+    SYM(SYMGreaterThanEqualsPattern, SYM_GreaterThanEquals, ">=")\
+    SYM(SYMLessThanPattern, SYM_LessThan, "<")\
+    SYM(SYMGreaterThanPattern, SYM_GreaterThan, ">")\
+    SYM(SYMAssignPattern, SYM_Assign, "=")
+
+#endif
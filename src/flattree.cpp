@@ -0,0 +1,112 @@
+#include <flattree.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+
+    static bool IsUsable(const TokenNode& item) {
+        return item && (item->is_token ? (item->token != nullptr) : (item->node != nullptr));
+    }
+
+    FlatTreeBase::FlatTreeBase(Tree tree) {
+        if (!tree)
+            Fatal("Trying to flatten a nullptr tree\n");
+
+        struct Pending {
+            TokenNode item;
+            Index parent;
+            // Where the item's index goes in children
+            size_t slot;
+            // Into owners, what keeps the item's top level item alive
+            size_t owner;
+        };
+
+        // Walked with a stack of its own, nesting can go deeper than the
+        // call stack allows
+        std::vector<Pending> stack;
+        std::vector<TokenNode> found;
+        std::vector<std::shared_ptr<const void>> owners(tree->size());
+
+        for (size_t i = tree->size(); i > 0; i--) {
+            const TokenNode& item = (*tree)[i-1];
+            owners[i-1] = GetOwner(*tree, item);
+
+            if (IsUsable(item))
+                stack.push_back({ item, None, 0, i-1 });
+        }
+
+        while (!stack.empty()) {
+            Pending pending = stack.back();
+            stack.pop_back();
+
+            Index index = (Index)kinds.size();
+            const TokenNode& item = pending.item;
+
+            if (pending.parent == None)
+                roots.push_back(index);
+            else
+                children[pending.slot] = index;
+
+            parents.push_back(pending.parent);
+            items.push_back(ShareOwnership(item, owners[pending.owner]));
+
+            if (item->is_token) {
+                kinds.push_back((uint16_t)(TreeNodeBase::TypeCount + (size_t)item->token->GetType()));
+                token_indices.push_back((Index)tokens.size());
+                tokens.push_back(item->token);
+                ranges.push_back({ (Index)children.size(), (Index)children.size() });
+                continue;
+            }
+
+            kinds.push_back((uint16_t)item->node->GetType());
+            token_indices.push_back(None);
+
+            found.clear();
+            item->node->GetChildren(found);
+
+            size_t count = 0;
+            for (auto& child : found) {
+                if (IsUsable(child))
+                    found[count++] = child;
+            }
+
+            Range range = { (Index)children.size(), (Index)(children.size() + count) };
+            ranges.push_back(range);
+            children.resize(range.end, None);
+
+            for (size_t i = count; i > 0; i--)
+                stack.push_back({ found[i-1], index, range.begin + i - 1, pending.owner });
+        }
+
+        // Children come after their parent, so the last child's subtree
+        // ends where the parent's does
+        ends.resize(kinds.size());
+        for (size_t i = kinds.size(); i > 0; i--) {
+            Index index = (Index)(i - 1);
+            const Range& range = ranges[index];
+
+            ends[index] = (range.begin == range.end) ? index + 1 : ends[children[range.end - 1]];
+        }
+    }
+
+    std::vector<FlatTreeBase::Index> FlatTreeBase::FindAll(TreeNodeBase::Type type) const {
+        std::vector<Index> found;
+        uint16_t kind = (uint16_t)type;
+
+        for (size_t i = 0; i < kinds.size(); i++) {
+            if (kinds[i] == kind)
+                found.push_back((Index)i);
+        }
+
+        return found;
+    }
+
+    std::vector<TreeNode> FlatTreeBase::GetAllNodesOfType(TreeNodeBase::Type type) const {
+        std::vector<TreeNode> list;
+
+        for (Index index : FindAll(type))
+            list.push_back(ShareOwnership(items[index]->node, items[index]));
+
+        return list;
+    }
+
+}
@@ -0,0 +1,106 @@
+#include <hash.hpp>
+
+#include <cstring>
+
+namespace Martin {
+
+    static const uint64_t prime1 = 0x9E3779B185EBCA87;
+    static const uint64_t prime2 = 0xC2B2AE3D27D4EB4F;
+    static const uint64_t prime3 = 0x165667B19E3779F9;
+    static const uint64_t prime4 = 0x85EBCA77C2B2AE63;
+    static const uint64_t prime5 = 0x27D4EB2F165667C5;
+
+    static inline uint64_t Rotate(uint64_t value, unsigned int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // Little endian loads, so the hash is the same on every machine
+    static inline uint64_t Read64(const uint8_t* data) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+#else
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; i++)
+            value |= (uint64_t)data[i] << (i * 8);
+#endif
+
+        return value;
+    }
+
+    static inline uint32_t Read32(const uint8_t* data) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+#else
+        return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+#endif
+    }
+
+    static inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+        accumulator += input * prime2;
+        return Rotate(accumulator, 31) * prime1;
+    }
+
+    static inline uint64_t Merge(uint64_t hash, uint64_t accumulator) {
+        hash ^= Round(0, accumulator);
+        return hash * prime1 + prime4;
+    }
+
+    uint64_t Hash64(std::string_view data, uint64_t seed) {
+        const uint8_t* p = (const uint8_t*)data.data();
+        const uint8_t* end = p + data.length();
+        uint64_t hash;
+
+        if (data.length() >= 32) {
+            uint64_t v1 = seed + prime1 + prime2;
+            uint64_t v2 = seed + prime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - prime1;
+
+            // Four independent lanes of 8 bytes per 32 byte stripe
+            do {
+                v1 = Round(v1, Read64(p));
+                v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16));
+                v4 = Round(v4, Read64(p + 24));
+                p += 32;
+            } while (p + 32 <= end);
+
+            hash = Rotate(v1, 1) + Rotate(v2, 7) + Rotate(v3, 12) + Rotate(v4, 18);
+            hash = Merge(hash, v1);
+            hash = Merge(hash, v2);
+            hash = Merge(hash, v3);
+            hash = Merge(hash, v4);
+        } else
+            hash = seed + prime5;
+
+        hash += (uint64_t)data.length();
+
+        for (; p + 8 <= end; p += 8) {
+            hash ^= Round(0, Read64(p));
+            hash = Rotate(hash, 27) * prime1 + prime4;
+        }
+
+        if (p + 4 <= end) {
+            hash ^= (uint64_t)Read32(p) * prime1;
+            hash = Rotate(hash, 23) * prime2 + prime3;
+            p += 4;
+        }
+
+        for (; p < end; p++) {
+            hash ^= (uint64_t)(*p) * prime5;
+            hash = Rotate(hash, 11) * prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= prime2;
+        hash ^= hash >> 29;
+        hash *= prime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+}
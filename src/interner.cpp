@@ -0,0 +1,94 @@
+#include <interner.hpp>
+
+#include <cstring>
+#include <functional>
+
+namespace Martin {
+
+    size_t Interner::GetShard(std::string_view spelling) {
+        // The low bits pick the bucket inside a shard's map, use the high ones here
+        size_t hash = std::hash<std::string_view>()(spelling);
+        return (hash >> (sizeof(size_t) * 8 - shard_bits)) & (shard_count - 1);
+    }
+
+    Symbol Interner::Intern(std::string_view spelling) {
+        size_t index = GetShard(spelling);
+        Shard& shard = shards[index];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.interned++;
+        shard.bytes_interned += spelling.length();
+
+        auto found = shard.symbols.find(spelling);
+        if (found != shard.symbols.end())
+            return found->second;
+
+        // Null terminated so users can keep treating spellings as C strings
+        size_t size = spelling.length() + 1;
+        char* data;
+
+        if (size > block_size) {
+            shard.large.push_back(std::unique_ptr<char[]>(new char[size]));
+            data = shard.large.back().get();
+        } else {
+            if (shard.block_used + size > block_size) {
+                shard.blocks.push_back(std::unique_ptr<char[]>(new char[block_size]));
+                shard.block_used = 0;
+            }
+
+            data = shard.blocks.back().get() + shard.block_used;
+            shard.block_used += size;
+        }
+
+        std::memcpy(data, spelling.data(), spelling.length());
+        data[spelling.length()] = '\0';
+
+        std::string_view stored(data, spelling.length());
+        Symbol symbol = (Symbol)((shard.spellings.size() << shard_bits) | index);
+
+        shard.spellings.push_back(stored);
+        shard.symbols[stored] = symbol;
+        shard.bytes_stored += size;
+
+        return symbol;
+    }
+
+    Symbol Interner::Find(std::string_view spelling) const {
+        const Shard& shard = shards[GetShard(spelling)];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto found = shard.symbols.find(spelling);
+        if (found == shard.symbols.end())
+            return InvalidSymbol;
+
+        return found->second;
+    }
+
+    std::string_view Interner::GetSpelling(Symbol symbol) const {
+        const Shard& shard = shards[symbol & (shard_count - 1)];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        return shard.spellings[symbol >> shard_bits];
+    }
+
+    Interner::Stats Interner::GetStats() const {
+        Stats stats = { 0, 0, 0, 0 };
+
+        for (const Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+
+            stats.interned += shard.interned;
+            stats.unique += shard.spellings.size();
+            stats.bytes_interned += shard.bytes_interned;
+            stats.bytes_stored += shard.bytes_stored;
+        }
+
+        return stats;
+    }
+
+    Interner InternerSingleton;
+
+}
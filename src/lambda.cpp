@@ -12,20 +12,28 @@ namespace Martin {
         num = 0;
     }
 
-    void ProcessLambdas(Tree tree, const std::string& module_name) {
-        auto list = Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::Misc_Lambda);
+    static void ProcessLambda(Tree tree, TreeNode node, const std::string& module_name) {
+        auto lambda = std::static_pointer_cast<LambdaTreeNode>(node);
+
+        lambda->has_name = true;
+        lambda->name = module_name + std::string("_lambda_") + std::to_string(num++);
 
-        for (auto node : list) {
-            auto lambda = std::static_pointer_cast<LambdaTreeNode>(node);
+        // The function isn't in the lambda's arena, its parts keep it alive
+        TreeNode op = MakeTreeNode<FuncTreeNode>(ShareOwnership(lambda->arrow, node), ShareOwnership(lambda->scope, node));
+        TokenNode token_node = MakeTokenNode();
+        token_node->node = op;
+        Parser::Append(tree, token_node);
+    }
 
-            lambda->has_name = true;
-            lambda->name = module_name + std::string("_lambda_") + std::to_string(num++);
+    void ProcessLambdas(Tree tree, const std::string& module_name) {
+        // A copy, appending adds the lambdas inside the ones found again
+        for (auto node : Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::Misc_Lambda))
+            ProcessLambda(tree, node, module_name);
+    }
 
-            TreeNode op = TreeNode(new FuncTreeNode(lambda->arrow, lambda->scope));
-            TokenNode token_node = TokenNode(new TokenNodeBase);
-            token_node->node = op;
-            tree->push_back(token_node);
-        }
+    void ProcessLambdas(Tree tree, FlatTree flat, const std::string& module_name) {
+        for (auto node : flat->GetAllNodesOfType(TreeNodeBase::Type::Misc_Lambda))
+            ProcessLambda(tree, node, module_name);
     }
 
 }
\ No newline at end of file
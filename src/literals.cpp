@@ -0,0 +1,66 @@
+#include "literals.hpp"
+
+#include <charconv>
+
+namespace Martin::Literals {
+
+    static Numbers::Result DecodeUInteger(std::string_view span, uintmax_t& value) {
+        unsigned int radix = 10;
+        size_t i = 1;
+
+        if (span.length() > i) {
+            switch (span[i]) {
+                case 'x':
+                case 'X':
+                    radix = 16;
+                    i++;
+                    break;
+                case 'o':
+                case 'O':
+                    radix = 8;
+                    i++;
+                    break;
+                case 'b':
+                case 'B':
+                    radix = 2;
+                    i++;
+                    break;
+            }
+        }
+
+        return Numbers::ParseUnsigned(span.substr(i), radix, value);
+    }
+
+    Numbers::Result DecodeNumber(TokenType::Type kind, std::string_view span, TokenValue& value) {
+        Numbers::Result result = Numbers::Result::Ok;
+        value.uinteger = 0;
+
+        switch (kind) {
+            case TokenType::Type::FloatingSingle:
+                value.single = 0.0f;
+
+                // Without the trailing f
+                std::from_chars(span.data(), span.data() + span.length() - 1, value.single);
+                break;
+            
+            case TokenType::Type::FloatingDouble:
+                value.floating = 0.0;
+                std::from_chars(span.data(), span.data() + span.length(), value.floating);
+                break;
+            
+            case TokenType::Type::UInteger:
+                result = DecodeUInteger(span, value.uinteger);
+                break;
+            
+            case TokenType::Type::Integer:
+                result = Numbers::ParseSigned(span, value.integer);
+                break;
+            
+            default:
+                break;
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,18 @@
+#ifndef MARTIN_LITERALS
+#define MARTIN_LITERALS
+
+#include <string_view>
+
+#include <numbers.hpp>
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+
+namespace Martin::Literals {
+
+    // Value of a number literal of the given kind from its source span,
+    // Overflow when it doesn't fit UIntMax or Int64
+    Numbers::Result DecodeNumber(TokenType::Type kind, std::string_view span, TokenValue& value);
+
+}
+
+#endif
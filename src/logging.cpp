@@ -145,6 +145,6 @@ namespace Martin::LoggingUtil {
     Logger* ErrorLogger = new ErrorLoggingClass;
     Logger* WarningLogger = new WarningLoggingClass;
     Logger* PrintLogger = new PrintLoggingClass;
-    Formatter* FormatFormatter = new Formatter;
+    thread_local Formatter FormatFormatter;
 
 }
\ No newline at end of file
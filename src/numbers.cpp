@@ -0,0 +1,189 @@
+#include <numbers.hpp>
+
+#include <cstring>
+
+// Eight digits are loaded as one little endian word, first digit in the low byte
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) || defined(_MSC_VER)
+#define MARTIN_NUMBERS_SWAR
+#endif
+
+namespace Martin::Numbers {
+
+    static const uint64_t ones = 0x0101010101010101;
+
+    // Value of c as a digit, 0xFF when it isn't one in any radix we parse
+    static uint8_t DigitValue(char c) {
+        if ((c >= '0') && (c <= '9'))
+            return c - '0';
+        
+        else if ((c >= 'a') && (c <= 'f'))
+            return c - 'a' + 10;
+        
+        else if ((c >= 'A') && (c <= 'F'))
+            return c - 'A' + 10;
+        
+        return 0xFF;
+    }
+
+    struct Limits {
+        // radix^8, what the value gets multiplied by for eight digits
+        uintmax_t step;
+        // Below these another digit or another eight digits can't overflow,
+        // so the exact check only runs for values close to the top
+        uintmax_t safe;
+        uintmax_t step_safe;
+    };
+
+    static constexpr Limits MakeLimits(uintmax_t radix) {
+        uintmax_t step = radix * radix * radix * radix * radix * radix * radix * radix;
+        return { step, UINTMAX_MAX / radix, UINTMAX_MAX / step };
+    }
+
+    static const Limits& GetLimits(unsigned int radix) {
+        static constexpr Limits limits[] = { MakeLimits(2), MakeLimits(8), MakeLimits(10), MakeLimits(16) };
+
+        switch (radix) {
+            case 2:
+                return limits[0];
+            case 8:
+                return limits[1];
+            case 16:
+                return limits[3];
+            default:
+                return limits[2];
+        }
+    }
+
+#ifdef MARTIN_NUMBERS_SWAR
+    // Turns eight ASCII digits into their byte values, false when any of them
+    // isn't a digit of the radix. Separators fail here and go the slow way
+    static bool LoadDigits(const char* data, unsigned int radix, uint64_t& digits) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+
+        switch (radix) {
+            case 2:
+                if ((word & (0xFE * ones)) != (0x30 * ones))
+                    return false;
+                break;
+            
+            case 8:
+                if ((word & (0xF8 * ones)) != (0x30 * ones))
+                    return false;
+                break;
+            
+            case 10:
+                // High nibble 3, and adding 6 doesn't carry out of the low nibble
+                if (((word & (0xF0 * ones)) != (0x30 * ones)) || (((word + 0x06 * ones) & (0xF0 * ones)) != (0x30 * ones)))
+                    return false;
+                break;
+            
+            default: {
+                // Letters don't have a closed form check, convert each byte
+                uint8_t bytes[8];
+                uint8_t invalid = 0;
+
+                for (size_t i = 0; i < 8; i++) {
+                    bytes[i] = DigitValue(data[i]);
+                    invalid |= bytes[i] & 0xF0;
+                }
+
+                if (invalid)
+                    return false;
+
+                std::memcpy(&digits, bytes, sizeof(digits));
+                return true;
+            }
+        }
+
+        digits = word - 0x30 * ones;
+        return true;
+    }
+
+    // Combines eight digit bytes pairwise, then in fours, then into one value
+    static uint64_t CombineDigits(uint64_t digits, uint64_t radix) {
+        digits = ((digits & 0x00FF00FF00FF00FF) * radix) + ((digits >> 8) & 0x00FF00FF00FF00FF);
+        digits = ((digits & 0x0000FFFF0000FFFF) * (radix * radix)) + ((digits >> 16) & 0x0000FFFF0000FFFF);
+        return ((digits & 0xFFFFFFFF) * (radix * radix * radix * radix)) + (digits >> 32);
+    }
+#endif
+
+    Result ParseUnsigned(std::string_view digits, unsigned int radix, uintmax_t& value) {
+        uintmax_t result = 0;
+        size_t i = 0;
+
+        const Limits& limits = GetLimits(radix);
+        uintmax_t safe = limits.safe;
+
+#ifdef MARTIN_NUMBERS_SWAR
+        uintmax_t step = limits.step;
+        uintmax_t step_safe = limits.step_safe;
+#endif
+
+        while (i < digits.length()) {
+#ifdef MARTIN_NUMBERS_SWAR
+            uint64_t chunk;
+            if ((i + 8 <= digits.length()) && LoadDigits(digits.data() + i, radix, chunk)) {
+                uintmax_t eight = CombineDigits(chunk, radix);
+
+                if ((result >= step_safe) && (result > (UINTMAX_MAX - eight) / step))
+                    return Result::Overflow;
+
+                result = result * step + eight;
+                i += 8;
+                continue;
+            }
+#endif
+
+            char c = digits[i++];
+            if (c == '_')
+                continue;
+
+            uint8_t digit = DigitValue(c);
+            if (digit >= radix)
+                return Result::InvalidDigit;
+
+            if ((result >= safe) && (result > (UINTMAX_MAX - digit) / radix))
+                return Result::Overflow;
+
+            result = result * radix + digit;
+        }
+
+        value = result;
+        return Result::Ok;
+    }
+
+    size_t GetSafeDigits(unsigned int radix, bool is_signed) {
+        // The largest n with radix^n at most 2^64, or 2^63 signed
+        switch (radix) {
+            case 2:
+                return is_signed ? 63 : 64;
+            case 8:
+                return 21;
+            case 16:
+                return is_signed ? 15 : 16;
+            default:
+                return is_signed ? 18 : 19;
+        }
+    }
+
+    Result ParseSigned(std::string_view text, intmax_t& value) {
+        bool negative = (text.length() > 0) && (text[0] == '-');
+        if (negative)
+            text.remove_prefix(1);
+
+        uintmax_t magnitude;
+        Result result = ParseUnsigned(text, 10, magnitude);
+        if (result != Result::Ok)
+            return result;
+
+        // The negative range reaches one further than the positive one
+        uintmax_t limit = (uintmax_t)INTMAX_MAX + (negative ? 1 : 0);
+        if (magnitude > limit)
+            return Result::Overflow;
+
+        value = negative ? (intmax_t)(0 - magnitude) : (intmax_t)magnitude;
+        return Result::Ok;
+    }
+
+}
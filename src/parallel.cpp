@@ -0,0 +1,149 @@
+#include <parallel.hpp>
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace Martin {
+
+    size_t GetDefaultThreadCount() {
+        size_t threads = std::thread::hardware_concurrency();
+        return threads ? threads : 1;
+    }
+
+    namespace {
+
+        // One ParallelFor call. Helpers join it until the caller runs out of
+        // indices and closes it, then the caller waits only for the ones that
+        // joined, so tickets nobody got to in time are simply dropped
+        struct Job {
+            Job(size_t count, const std::function<void(size_t)>& func) : count(count), func(func) {}
+
+            void Work() {
+                for (size_t i = next++; i < count; i = next++) {
+                    try {
+                        func(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+
+                        // Nobody takes another index
+                        next = count;
+                    }
+                }
+            }
+
+            bool Join() {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (closed)
+                    return false;
+
+                active++;
+                return true;
+            }
+
+            void Leave() {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--active == 0)
+                    finished.notify_all();
+            }
+
+            void CloseAndWait() {
+                std::unique_lock<std::mutex> lock(mutex);
+                closed = true;
+                finished.wait(lock, [this]() { return active == 0; });
+            }
+
+            const size_t count;
+            const std::function<void(size_t)>& func;
+            std::atomic<size_t> next { 0 };
+
+            std::mutex mutex;
+            std::condition_variable finished;
+            size_t active = 0;
+            bool closed = false;
+            std::exception_ptr error;
+        };
+
+        // Threads started the first time they're needed and kept for later
+        // calls. Each ticket lets one thread help with its job
+        class WorkerPool {
+        public:
+            void Submit(const std::shared_ptr<Job>& job, size_t helpers) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                while (workers.size() < helpers)
+                    workers.push_back(std::thread([this]() { Run(); }));
+
+                for (size_t i = 0; i < helpers; i++)
+                    tickets.push_back(job);
+
+                waiting.notify_all();
+            }
+
+        private:
+            void Run() {
+                while (true) {
+                    std::shared_ptr<Job> job;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        waiting.wait(lock, [this]() { return !tickets.empty(); });
+
+                        job = std::move(tickets.front());
+                        tickets.pop_front();
+                    }
+
+                    if (job->Join()) {
+                        job->Work();
+                        job->Leave();
+                    }
+                }
+            }
+
+            std::mutex mutex;
+            std::condition_variable waiting;
+            std::deque<std::shared_ptr<Job>> tickets;
+            std::vector<std::thread> workers;
+        };
+
+        // Never destroyed, its threads wait on it until the process exits
+        WorkerPool& GetPool() {
+            static WorkerPool* pool = new WorkerPool;
+            return *pool;
+        }
+
+    }
+
+    void ParallelFor(size_t count, const std::function<void(size_t)>& func, size_t threads) {
+        if (threads == 0)
+            threads = GetDefaultThreadCount();
+
+        if (threads > count)
+            threads = count;
+
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; i++)
+                func(i);
+
+            return;
+        }
+
+        auto job = std::make_shared<Job>(count, func);
+        GetPool().Submit(job, threads - 1);
+
+        // The calling thread works too, so nested calls and busy pools still
+        // get through every index
+        job->Work();
+        job->CloseAndWait();
+
+        if (job->error)
+            std::rethrow_exception(job->error);
+    }
+
+}
@@ -1,7 +1,11 @@
 #include <parse.hpp>
+#include <flattree.hpp>
+#include <algorithm>
+#include <mutex>
 #include <tokens.hpp>
-#include <fstream>
-#include <sstream>
+#include <tokenbuffer.hpp>
+#include <tokenstream.hpp>
+#include <parallel.hpp>
 
 #include "generators/addsub.hpp"
 #include "generators/muldivmod.hpp"
@@ -32,6 +36,7 @@
 #include "generators/gettersetter.hpp"
 #include "generators/seperator.hpp"
 #include "generators/rettypes.hpp"
+#include "generators/expressions.hpp"
 
 namespace Martin {
 
@@ -43,13 +48,9 @@ namespace Martin {
         generators.push_back(TreeGenerator(new OPDotTreeGenerator));
         generators.push_back(TreeGenerator(new CallTreeGenerator));
         generators.push_back(TreeGenerator(new StructAsTreeGenerator));
-        generators.push_back(TreeGenerator(new OPMulDivModTreeGenerator));
-        generators.push_back(TreeGenerator(new OPPowTreeGenerator));
-        generators.push_back(TreeGenerator(new OPAddSubTreeGenerator));
-        generators.push_back(TreeGenerator(new OPBitwiseTreeGenerator));
-        generators.push_back(TreeGenerator(new OPEqualityTreeGenerator));
-        generators.push_back(TreeGenerator(new OPNotLogicTreeGenerator));
-        generators.push_back(TreeGenerator(new OPLogicalsTreeGenerator));
+        // Stands in for the MulDivMod, Pow, AddSub, Bitwise, Equality,
+        // NotLogic and Logicals sweeps, in that order of precedence
+        generators.push_back(TreeGenerator(new OPExpressionsTreeGenerator));
         generators.push_back(TreeGenerator(new AccessTypesTreeGenerator));
         generators.push_back(TreeGenerator(new ArrowTreeGenerator));
         generators.push_back(TreeGenerator(new LambdaTreeGenerator));
@@ -69,58 +70,300 @@ namespace Martin {
         generators.push_back(TreeGenerator(new ColonTreeGenerator));
         generators.push_back(TreeGenerator(new ClassTreeGenerator));
         generators.push_back(TreeGenerator(new ExternTreeGenerator));
+
+        SetTriggers();
+    }
+
+    Parser::Parser(const std::vector<TreeGenerator>& generators) : generators(generators) {
+        SetTriggers();
+    }
+
+    void Parser::SetTriggers() {
+        for (auto gen : generators) {
+            TriggerSet set;
+            if (gen->GetTriggers(set))
+                triggers.push_back(std::unique_ptr<TriggerSet>(new TriggerSet(set)));
+            else
+                triggers.push_back(nullptr);
+        }
     }
 
     Tree Parser::ParseFile(const std::string& path, std::string& error_msg) {
-        std::ifstream file(path);
-        if (!file.is_open()) {
-            error_msg = Format("Could not open file: $", path);
+        SourceBuffer source = SourceBufferBase::FromFile(path, error_msg);
+        if (!source)
             return nullptr;
-        }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        file.close();
+        return ParseTokens(TokenizerSingleton.TokenizeParallel(source));
+    }
 
-        std::string code = buffer.str();
+    Tree Parser::ParseString(const std::string& code, std::string& error_msg) {
+        auto buffer = TokenizerSingleton.TokenizeBuffer(code);
+        auto tree = ParseTokens(buffer);
 
-        return ParseString(code, error_msg);
+        return tree;
     }
 
-    Tree Parser::ParseString(const std::string& code, std::string& error_msg) {
-        auto token_array = TokenizerSingleton.TokenizeString(code);
-        auto tree = ParserSingleton.ParseTokens(token_array);
+    Tree Parser::ParseTokens(TokenBuffer buffer) {
+        return ParseTokens(CreateTokenList(buffer));
+    }
+
+    // The items at the tree's top level keep the arena alive, lookups hand
+    // out nodes that share it
+    template <typename F>
+    static Tree ParseInOwnArena(const Parser& parser, F parse) {
+        std::shared_ptr<AstArena> arena = std::make_shared<AstArena>();
+        Tree tree;
+
+        {
+            AstArena::Scope scope(arena.get());
+            ParseSession session(parser, arena.get());
+            tree = parse(session);
+        }
+
+        for (auto& item : *tree)
+            item = TokenNode(arena, item.get());
+
+        tree->SetIndex(NodeIndex(new NodeIndexBase(tree)));
 
         return tree;
     }
 
+    // Parses into the current arena when the caller set one up, keeping it
+    // alive is up to them then. Otherwise the file gets an arena of its own
+    template <typename F>
+    static Tree ParseInSession(const Parser& parser, F parse) {
+        if (AstArena* current = AstArena::GetCurrent()) {
+            ParseSession session(parser, current);
+            Tree tree = parse(session);
+            tree->SetIndex(NodeIndex(new NodeIndexBase(tree)));
+            return tree;
+        }
+
+        return ParseInOwnArena(parser, parse);
+    }
+
+    Tree Parser::ParseTokens(TokenStream stream) {
+        return ParseInSession(*this, [&](ParseSession& session) {
+            Tree tree = Tree(new TreeBase);
+            TokenNode token_node;
+
+            while (Token tk = stream->Next()) {
+                token_node = MakeTokenNode();
+                token_node->token = tk;
+                token_node->is_token = true;
+                tree->push_back(token_node);
+            }
+
+            session.ParseBranch(tree, 0, tree->size());
+
+            return tree;
+        });
+    }
+
     Tree Parser::ParseTokens(TokenList tokens) {
-        Tree tree = Tree(new std::vector<TokenNode>);
+        return ParseInSession(*this, [&](ParseSession& session) {
+            Tree tree = Tree(new TreeBase);
+
+            tree->reserve(tokens->size());
+            TokenNode token_node;
+
+            for (auto tk : *tokens) {
+                token_node = MakeTokenNode();
+                token_node->token = tk;
+                token_node->is_token = true;
+                tree->push_back(token_node);
+            }
+
+            session.ParseBranch(tree, 0, tree->size());
+
+            return tree;
+        });
+    }
+
+    // Indices of func, class, struct and typedef tokens at the top level
+    // that come right after the closing brace of the declaration before
+    // them, at most one at or after each multiple of chunk. No generator
+    // reduces across those, so the pieces between them parse on their own.
+    // Unbalanced brackets give none
+    static std::vector<size_t> FindDeclarationBoundaries(const std::vector<Token>& tokens, size_t chunk) {
+        std::vector<size_t> boundaries;
+        size_t target = chunk;
+        size_t depth = 0;
+
+        for (size_t i = 0; i < tokens.size(); i++) {
+            switch (tokens[i]->GetType()) {
+                case TokenType::Type::SYM_OpenCurly:
+                case TokenType::Type::SYM_OpenBracket:
+                case TokenType::Type::SYM_OpenParentheses:
+                    depth++;
+                    break;
+
+                case TokenType::Type::SYM_CloseCurly:
+                case TokenType::Type::SYM_CloseBracket:
+                case TokenType::Type::SYM_CloseParentheses:
+                    if (depth == 0)
+                        return {};
+
+                    depth--;
+                    break;
+
+                case TokenType::Type::KW_Func:
+                case TokenType::Type::KW_Class:
+                case TokenType::Type::KW_Struct:
+                case TokenType::Type::KW_Typedef:
+                    if ((depth == 0) && (i >= target) && (tokens[i - 1]->GetType() == TokenType::Type::SYM_CloseCurly)) {
+                        boundaries.push_back(i);
+                        target = i + chunk;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (depth != 0)
+            return {};
+
+        return boundaries;
+    }
 
-        tree->reserve(tokens->size());
-        TokenNode token_node;
+    Tree Parser::ParseParallel(TokenList tokens, size_t threads) {
+        // Below this, splitting costs more than it saves
+        static const size_t min_chunk = 1 << 12;
 
-        for (auto tk : *tokens) {
-            token_node = TokenNode(new TokenNodeBase);
-            token_node->token = tk;
-            token_node->is_token = true;
-            tree->push_back(token_node);
+        if (threads == 0)
+            threads = GetDefaultThreadCount();
+
+        if ((threads <= 1) || (tokens->size() < min_chunk * 2))
+            return ParseTokens(tokens);
+
+        // A few chunks per thread keeps them busy when chunks parse at different speeds
+        size_t chunk = std::max(min_chunk, tokens->size() / (threads * 4));
+
+        std::vector<size_t> starts = FindDeclarationBoundaries(*tokens, chunk);
+        if (starts.empty())
+            return ParseTokens(tokens);
+
+        starts.insert(starts.begin(), 0);
+
+        std::vector<Tree> trees(starts.size());
+        std::atomic<bool> aligned(true);
+
+        // Every piece gets an arena of its own, arenas don't take allocations
+        // from several threads
+        ParallelFor(starts.size(), [&](size_t i) {
+            size_t end = (i + 1 < starts.size()) ? starts[i + 1] : tokens->size();
+
+            trees[i] = ParseInOwnArena(*this, [&](ParseSession& session) {
+                Tree tree = Tree(new TreeBase);
+
+                tree->reserve(end - starts[i]);
+                TokenNode token_node;
+
+                for (size_t t = starts[i]; t < end; t++) {
+                    token_node = MakeTokenNode();
+                    token_node->token = (*tokens)[t];
+                    token_node->is_token = true;
+                    tree->push_back(token_node);
+                }
+
+                session.ParseBranch(tree, 0, tree->size());
+
+                if (!session.IsAligned())
+                    aligned = false;
+
+                return tree;
+            });
+        }, threads);
+
+        // In one branch, passes after a misaligned one would have seen the
+        // pieces differently
+        if (!aligned)
+            return ParseTokens(tokens);
+
+        Tree tree = trees[0];
+        NodeIndex index = tree->GetIndex();
+
+        for (size_t i = 1; i < trees.size(); i++) {
+            tree->insert(tree->end(), trees[i]->begin(), trees[i]->end());
+            index->Add(*trees[i]->GetIndex());
+            trees[i].reset();
         }
 
-        ParseBranch(tree, 0, tree->size());
+        tree->SetIndex(index);
 
         return tree;
     }
 
     void Parser::ParseBranch(Tree tree, size_t start, size_t end) {
+        ParseSession session(*this);
+        session.ParseBranch(tree, start, end);
+    }
+
+    ParseSession::ParseSession(const Parser& parser, AstArena* arena) : parser(parser), arena(arena) {}
+
+    ParseSession::~ParseSession() {
+        parser.calls += counters.calls;
+        parser.avoided += counters.avoided;
+    }
+
+    void ParseSession::ParseBranch(Tree tree, size_t start, size_t end) {
+        if (!tree)
+            Fatal("Trying to parse a nullptr tree\n");
+
+        // Nested branches find the arena already current
+        std::unique_ptr<AstArena::Scope> scope;
+        if (arena && (AstArena::GetCurrent() != arena))
+            scope.reset(new AstArena::Scope(arena));
+
+        const std::vector<TreeGenerator>& generators = parser.generators;
+        const std::vector<std::unique_ptr<TriggerSet>>& triggers = parser.triggers;
+
         size_t removed, index;
 
-        for (auto gen : generators) {
-            if (gen->IsReversed()) {
+        // Token kinds from start on. Items past end can still slide into
+        // the branch, so they count too. Passes only take tokens away, so
+        // it stays good until a pass adds items
+        TriggerSet present;
+        bool stale = true;
+
+        bool outermost = (depth++ == 0);
+        if (outermost && (end != tree->size()))
+            aligned = false;
+
+        for (size_t g = 0; g < generators.size(); g++) {
+            const TreeGenerator& gen = generators[g];
+            const TriggerSet* fires = triggers[g].get();
+
+            if (fires && stale) {
+                present = TriggerSet();
+                for (size_t i = start; i < tree->size(); i++) {
+                    const TokenNode& item = (*tree)[i];
+                    if (item->is_token)
+                        present.Add(item->token->GetType());
+                }
+                stale = false;
+            }
+
+            size_t before = tree->size();
+
+            if (gen->IsRanged()) {
+                end -= gen->ProcessRange(*this, tree, start, end);
+            } else if (fires && !fires->CanFire(present)) {
+                counters.avoided += std::min(end, tree->size()) - std::min(start, end);
+            } else if (gen->IsReversed()) {
                 index = end - 1;
                 size_t accum = 0;
                 while ((index < end) && (index >= start) && (index < tree->size())) {
-                    removed = gen->ProcessBranch(tree, index, end);
+                    if (fires && !fires->Matches((*tree)[index])) {
+                        counters.avoided++;
+                        index--;
+                        continue;
+                    }
+
+                    counters.calls++;
+                    removed = gen->ProcessBranch(*this, tree, index, end);
                     if (removed)
                         accum += removed - 1;
                     
@@ -130,7 +373,14 @@ namespace Martin {
             } else {
                 index = start;
                 while ((index < end) && (index < tree->size())) {
-                    removed = gen->ProcessBranch(tree, index, end);
+                    if (fires && !fires->Matches((*tree)[index])) {
+                        counters.avoided++;
+                        index++;
+                        continue;
+                    }
+
+                    counters.calls++;
+                    removed = gen->ProcessBranch(*this, tree, index, end);
                     if (removed)
                         end -= removed - 1;
                     
@@ -138,36 +388,280 @@ namespace Martin {
                         index++;
                 }
             }
+
+            if (tree->size() > before)
+                stale = true;
+
+            if (outermost && (end != tree->size()))
+                aligned = false;
         }
+
+        depth--;
+    }
+
+    Parser::Counters Parser::GetCounters() const {
+        Counters counters;
+        counters.calls = calls;
+        counters.avoided = avoided;
+        return counters;
+    }
+
+    void Parser::ResetCounters() {
+        calls = 0;
+        avoided = 0;
     }
 
     bool Parser::Valid(Tree tree) {
+        bool valid = true;
+
         for (auto node : *tree) {
             if (node->is_token) {
                 Warning("Found a token in the toplevel of the parse tree: $\n", *node);
-                return false;
+                valid = false;
             }
-            if (!node->node->Valid()) {
-                Warning("Node $ is not valid\n", *node);
-                return false;
+        }
+
+        for (auto node : FindInvalid(tree)) {
+            Warning("Node $ is invalid on line $\n", node->GetName(), node->GetLineNumber());
+            valid = false;
+        }
+
+        return valid;
+    }
+
+    bool Parser::Valid(FlatTree tree) {
+        bool valid = true;
+
+        for (auto root : tree->GetRoots()) {
+            if (tree->IsToken(root)) {
+                Warning("Found a token in the toplevel of the parse tree: $\n", *tree->GetItem(root));
+                valid = false;
             }
         }
 
-        return true;
+        for (auto node : FindInvalid(tree)) {
+            Warning("Node $ is invalid on line $\n", node->GetName(), node->GetLineNumber());
+            valid = false;
+        }
+
+        return valid;
     }
 
-    std::vector<TreeNode> Parser::GetAllNodesOfType(Tree tree, TreeNodeBase::Type type) {
-        std::vector<TreeNode> list;
+    // Follows the invalid children of an invalid node down to the nodes
+    // without any
+    static void FindInvalidBelow(const TreeNode& node, const std::shared_ptr<const void>& owner, std::vector<TreeNode>& invalid) {
+        std::vector<TokenNode> children;
+        node->GetChildren(children);
+
+        bool found = false;
+
+        for (auto child : children) {
+            if (!child || child->is_token || !child->node || child->node->Valid())
+                continue;
+
+            FindInvalidBelow(child->node, owner, invalid);
+            found = true;
+        }
+
+        if (!found)
+            invalid.push_back(ShareOwnership(node, owner));
+    }
+
+    std::vector<TreeNode> Parser::FindInvalid(Tree tree) {
+        std::vector<TreeNode> invalid;
 
         for (auto node : *tree) {
-            if (!node->is_token) {
-                if (node->node->GetType() == type) {
-                    list.push_back(node->node);
-                }
-                auto list2 = node->node->GetAllNodesOfType(type);
-                list.insert(list.end(), list2.begin(), list2.end());
+            if (node && !node->is_token && node->node && !node->node->Valid())
+                FindInvalidBelow(node->node, GetOwner(*tree, node), invalid);
+        }
+
+        return invalid;
+    }
+
+    std::vector<TreeNode> Parser::FindInvalid(FlatTree tree) {
+        std::vector<TreeNode> invalid;
+
+        // Goes over the items in order, skipping the subtrees of tokens,
+        // valid nodes and the nodes it finds
+        for (FlatTreeBase::Index index = 0; index < tree->size();) {
+            if (tree->IsToken(index) || tree->GetItem(index)->node->Valid()) {
+                index = tree->GetSubtreeEnd(index);
+                continue;
             }
+
+            bool found = false;
+
+            for (size_t child = 0; !found && (child < tree->GetChildCount(index)); child++) {
+                FlatTreeBase::Index item = tree->GetChild(index, child);
+                found = !tree->IsToken(item) && !tree->GetItem(item)->node->Valid();
+            }
+
+            if (found) {
+                index++;
+                continue;
+            }
+
+            invalid.push_back(ShareOwnership(tree->GetItem(index)->node, tree->GetItem(index)));
+            index = tree->GetSubtreeEnd(index);
+        }
+
+        return invalid;
+    }
+
+    std::vector<TreeNode> Parser::GetAllNodesOfType(Tree tree, TreeNodeBase::Type type) {
+        if (const NodeIndex& index = tree->GetIndex())
+            return index->Get(type);
+
+        std::vector<TreeNode> list;
+
+        for (const TokenNode& root : *tree) {
+            std::shared_ptr<const void> owner = GetOwner(*tree, root);
+
+            Walk(root, [&](const TokenNode& item) {
+                if (!item->is_token && (item->node->GetType() == type))
+                    list.push_back(ShareOwnership(item->node, owner));
+
+                return true;
+            });
+        }
+
+        return list;
+    }
+
+    void Parser::Append(Tree tree, const TokenNode& item) {
+        NodeIndex index = tree->GetIndex();
+
+        tree->push_back(item);
+
+        if (index) {
+            index->Add(item, GetOwner(*tree, item));
+            tree->SetIndex(index);
         }
+    }
+
+    NodeIndexBase::NodeIndexBase(Tree tree) : NodeIndexBase() {
+        if (!tree)
+            Fatal("Trying to index a nullptr tree\n");
+
+        for (const TokenNode& item : *tree)
+            Add(item, GetOwner(*tree, item));
+    }
+
+    void NodeIndexBase::Add(const TokenNode& item, const std::shared_ptr<const void>& owner) {
+        Walk(item, [&](const TokenNode& found) {
+            if (!found->is_token)
+                lists[(size_t)found->node->GetType()].push_back(ShareOwnership(found->node, owner));
+
+            return true;
+        });
+    }
+
+    void NodeIndexBase::Add(const NodeIndexBase& other) {
+        for (size_t type = 0; type < lists.size(); type++)
+            lists[type].insert(lists[type].end(), other.lists[type].begin(), other.lists[type].end());
+    }
+
+    // Valid counts of one thread. Only the thread itself writes them, so
+    // counting doesn't bounce a shared cache line between parsing threads.
+    // GetValidCounters sums them with the ones of threads that exited
+    struct ValidCounts {
+        ValidCounts();
+        ~ValidCounts();
+
+        std::atomic<size_t> calls { 0 };
+        std::atomic<size_t> checks { 0 };
+    };
+
+    static std::mutex valid_counts_mutex;
+    static std::vector<ValidCounts*> valid_counts;
+    static TreeNodeBase::ValidCounters exited_valid_counts;
+
+    static thread_local ValidCounts thread_valid_counts;
+
+    ValidCounts::ValidCounts() {
+        std::lock_guard<std::mutex> lock(valid_counts_mutex);
+        valid_counts.push_back(this);
+    }
+
+    ValidCounts::~ValidCounts() {
+        std::lock_guard<std::mutex> lock(valid_counts_mutex);
+        exited_valid_counts.calls += calls;
+        exited_valid_counts.checks += checks;
+        valid_counts.erase(std::find(valid_counts.begin(), valid_counts.end(), this));
+    }
+
+    // A plain load and store, nothing else writes the count
+    static void CountValid(std::atomic<size_t>& count) {
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    bool TreeNodeBase::Valid() const {
+        ValidCounts& counts = thread_valid_counts;
+        CountValid(counts.calls);
+
+        Validity known = validity.load(std::memory_order_relaxed);
+        if (known != Validity::Unchecked)
+            return known == Validity::Valid;
+
+        CountValid(counts.checks);
+
+        bool valid = CheckValid();
+        validity.store(valid ? Validity::Valid : Validity::Invalid, std::memory_order_relaxed);
+        return valid;
+    }
+
+    TreeNodeBase::ValidCounters TreeNodeBase::GetValidCounters() {
+        std::lock_guard<std::mutex> lock(valid_counts_mutex);
+        ValidCounters counters = exited_valid_counts;
+
+        for (ValidCounts* counts : valid_counts) {
+            counters.calls += counts->calls.load(std::memory_order_relaxed);
+            counters.checks += counts->checks.load(std::memory_order_relaxed);
+        }
+
+        return counters;
+    }
+
+    void TreeNodeBase::ResetValidCounters() {
+        std::lock_guard<std::mutex> lock(valid_counts_mutex);
+        exited_valid_counts = ValidCounters();
+
+        for (ValidCounts* counts : valid_counts) {
+            counts->calls.store(0, std::memory_order_relaxed);
+            counts->checks.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void TreeNodeBase::GetChildren(std::vector<TokenNode>& children) const {
+        class Collector : public ChildVisitor {
+        public:
+            Collector(std::vector<TokenNode>& children) : children(children) {}
+
+            bool Visit(const TokenNode& child) override {
+                children.push_back(child);
+                return true;
+            }
+
+        private:
+            std::vector<TokenNode>& children;
+        };
+
+        Collector collector(children);
+        VisitChildren(collector);
+    }
+
+    std::vector<TreeNode> TreeNodeBase::GetAllNodesOfType(Type type) const {
+        std::vector<TreeNode> list;
+
+        auto collect = [&](const TokenNode& item) {
+            if (!item->is_token && (item->node->GetType() == type))
+                list.push_back(item->node);
+
+            return true;
+        };
+
+        TreeWalker<decltype(collect)> walker(collect, WalkOrder::Preorder);
+        VisitChildren(walker);
 
         return list;
     }
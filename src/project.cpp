@@ -21,6 +21,10 @@ namespace Martin {
         return visibility;
     }
 
+    void Project::SetTokenCache(const std::string& directory) {
+        token_cache = std::unique_ptr<TokenCache>(new TokenCache(directory));
+    }
+
     void Project::LoadPackages(const std::string& starting_path) {
         //std::string proj_package_dir = proj_src_dir + "/" + local_package_paths;
     }
@@ -36,17 +40,28 @@ namespace Martin {
         ResetLambdaCounter();
 
         for (auto path : proj_files) {
-            tree = ParserSingleton.ParseFile(path, error);
+            if (token_cache) {
+                SourceBuffer source = SourceBufferBase::FromFile(path, error);
+                tree = source ? ParserSingleton.ParseTokens(token_cache->Tokenize(source)) : nullptr;
+            } else
+                tree = ParserSingleton.ParseFile(path, error);
+
             if (!tree) {
                 Fatal("Parser error: $\n", error);
             }
 
-            Parser::Valid(tree);
+            FlatTree flat = FlatTree(new FlatTreeBase(tree));
+
+            // Everything after this takes nodes to be what their type says,
+            // Valid warns about each problem first
+            if (!Parser::Valid(flat)) {
+                Fatal("Invalid code in $\n", path);
+            }
 
             files[path] = tree;
-            visibility[path] = std::unique_ptr<Visibility>(new Visibility(tree));
+            visibility[path] = std::unique_ptr<Visibility>(new Visibility(flat));
             
-            ProcessLambdas(tree, name);
+            ProcessLambdas(tree, flat, name);
         }
 
         LoadPackages(starting_path);
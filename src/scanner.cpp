@@ -0,0 +1,128 @@
+#include "scanner.hpp"
+
+#include <platform.hpp>
+
+#include <bitset>
+#include <cstring>
+#include <stdint.h>
+
+#if defined(cpu_x86) && defined(__AVX2__)
+#include <immintrin.h>
+#define MARTIN_SCANNER_AVX2
+#elif defined(cpu_x86) && (defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64))
+#include <emmintrin.h>
+#define MARTIN_SCANNER_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Martin::Scanner {
+
+#if defined(MARTIN_SCANNER_AVX2) || defined(MARTIN_SCANNER_SSE2)
+    static size_t LowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+#if defined(MARTIN_SCANNER_AVX2)
+    static const size_t block = 32;
+
+    static uint32_t MatchMask(const char* data, char a, char b) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)data);
+        __m256i match = _mm256_or_si256(
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(a)),
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(b))
+        );
+
+        return (uint32_t)_mm256_movemask_epi8(match);
+    }
+
+#elif defined(MARTIN_SCANNER_SSE2)
+    static const size_t block = 16;
+
+    static uint32_t MatchMask(const char* data, char a, char b) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)data);
+        __m128i match = _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8(a)),
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8(b))
+        );
+
+        return (uint32_t)_mm_movemask_epi8(match);
+    }
+
+#endif
+
+    size_t Find(std::string_view in, size_t start, char c) {
+        if (start >= in.length())
+            return std::string_view::npos;
+
+        // The C library's memchr is already vectorized on every platform we build for
+        const void* found = std::memchr(in.data() + start, c, in.length() - start);
+        if (!found)
+            return std::string_view::npos;
+
+        return (const char*)found - in.data();
+    }
+
+    size_t FindEither(std::string_view in, size_t start, char a, char b) {
+        size_t i = start;
+
+#if defined(MARTIN_SCANNER_AVX2) || defined(MARTIN_SCANNER_SSE2)
+        for (; i + block <= in.length(); i += block) {
+            uint32_t mask = MatchMask(in.data() + i, a, b);
+            if (mask)
+                return i + LowestBit(mask);
+        }
+#endif
+
+        for (; i < in.length(); i++) {
+            if ((in[i] == a) || (in[i] == b))
+                return i;
+        }
+
+        return std::string_view::npos;
+    }
+
+    size_t Count(std::string_view in, char c) {
+        size_t count = 0;
+        size_t i = 0;
+
+#if defined(MARTIN_SCANNER_AVX2) || defined(MARTIN_SCANNER_SSE2)
+        for (; i + block <= in.length(); i += block)
+            count += std::bitset<32>(MatchMask(in.data() + i, c, c)).count();
+#endif
+
+        for (; i < in.length(); i++) {
+            if (in[i] == c)
+                count++;
+        }
+
+        return count;
+    }
+
+    void FindAll(std::string_view in, char c, std::vector<uint32_t>& positions, uint32_t bias) {
+        size_t i = 0;
+
+#if defined(MARTIN_SCANNER_AVX2) || defined(MARTIN_SCANNER_SSE2)
+        for (; i + block <= in.length(); i += block) {
+            // Clearing the lowest set bit walks the matches in order
+            for (uint32_t mask = MatchMask(in.data() + i, c, c); mask; mask &= mask - 1)
+                positions.push_back((uint32_t)(i + LowestBit(mask)) + bias);
+        }
+#endif
+
+        for (; i < in.length(); i++) {
+            if (in[i] == c)
+                positions.push_back((uint32_t)i + bias);
+        }
+    }
+
+}
@@ -0,0 +1,25 @@
+#ifndef MARTIN_SCANNER
+#define MARTIN_SCANNER
+
+#include <string_view>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Martin::Scanner {
+
+    // Position of the first c at or after start, or npos
+    size_t Find(std::string_view in, size_t start, char c);
+
+    // Position of the first a or b at or after start, or npos
+    size_t FindEither(std::string_view in, size_t start, char a, char b);
+
+    // Number of times c occurs in in
+    size_t Count(std::string_view in, char c);
+
+    // Appends the position of every c in in, plus bias, to positions
+    void FindAll(std::string_view in, char c, std::vector<uint32_t>& positions, uint32_t bias = 0);
+
+}
+
+#endif
@@ -0,0 +1,288 @@
+#include <sourcebuffer.hpp>
+#include <platform.hpp>
+#include <logging.hpp>
+
+#include "scanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <fstream>
+#include <iostream>
+
+#ifdef unix
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Martin {
+
+    // Slots are allocated in chunks that never move or get freed, so lookups
+    // can find them without the lock. The one for InvalidFileID is never used
+    static const FileID slot_mask = (1u << FileSlotBits) - 1;
+    static const size_t chunk_size = 4096;
+    static const size_t chunk_count = (slot_mask + 1) / chunk_size;
+
+    std::atomic<SourceBufferBase::Slot*> SourceBufferBase::chunks[chunk_count];
+
+    // Freed slots are reused oldest first and only once this many are waiting,
+    // so a slot goes through its generations slowly
+    static const size_t min_free_slots = 4096;
+
+    struct Registry {
+        std::mutex mutex;
+        uint32_t used = 0;
+        std::deque<uint32_t> free;
+    };
+
+    // Never destroyed, sources held by statics can be freed after it would be
+    static Registry& GetRegistry() {
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    SourceBufferBase::Slot* SourceBufferBase::GetSlot(FileID id) {
+        if (id == InvalidFileID)
+            return nullptr;
+
+        Slot* chunk = chunks[(id & slot_mask) / chunk_size].load(std::memory_order_acquire);
+        return chunk ? &chunk[(id & slot_mask) % chunk_size] : nullptr;
+    }
+
+    SourceBuffer SourceBufferBase::Create() {
+        SourceBuffer source = SourceBuffer(new SourceBufferBase);
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        uint32_t index = 0;
+        if ((registry.free.size() >= min_free_slots) || ((registry.used == slot_mask) && !registry.free.empty())) {
+            index = registry.free.front();
+            registry.free.pop_front();
+        } else if (registry.used < slot_mask) {
+            index = registry.used++;
+
+            if (index % chunk_size == 0)
+                chunks[index / chunk_size].store(new Slot[chunk_size], std::memory_order_release);
+        } else {
+            Fatal("Ran out of file IDs\n");
+        }
+
+        Slot& slot = *GetSlot(index);
+        source->id = (slot.generation++ << FileSlotBits) | index;
+        slot.source.store(source.get());
+
+        return source;
+    }
+
+    SourceBuffer SourceBufferBase::FromFileID(FileID id) {
+        SourceBuffer found;
+        // Empty when the source is already being freed
+        WithFileID(id, [&](const SourceBufferBase& source) {
+            found = std::const_pointer_cast<SourceBufferBase>(source.weak_from_this().lock());
+        });
+
+        return found;
+    }
+
+    const std::vector<uint32_t>& SourceBufferBase::GetLineStarts() const {
+        std::call_once(line_flag, [this]() {
+            line_starts.reserve(Scanner::Count(GetView(), '\n') + 1);
+            line_starts.push_back(0);
+            Scanner::FindAll(GetView(), '\n', line_starts, 1);
+        });
+
+        return line_starts;
+    }
+
+    unsigned int SourceBufferBase::GetLine(size_t offset) const {
+        const std::vector<uint32_t>& starts = GetLineStarts();
+        return (unsigned int)(std::upper_bound(starts.begin(), starts.end(), offset) - starts.begin());
+    }
+
+    unsigned int SourceBufferBase::GetColumn(size_t offset) const {
+        const std::vector<uint32_t>& starts = GetLineStarts();
+        return (unsigned int)(offset - *(std::upper_bound(starts.begin(), starts.end(), offset) - 1)) + 1;
+    }
+
+    unsigned int GetLine(SourceLoc loc) {
+        unsigned int line = 0;
+        SourceBufferBase::WithFileID(loc.file, [&](const SourceBufferBase& source) {
+            line = source.GetLine(loc.offset);
+        });
+
+        return line;
+    }
+
+    unsigned int GetColumn(SourceLoc loc) {
+        unsigned int column = 0;
+        SourceBufferBase::WithFileID(loc.file, [&](const SourceBufferBase& source) {
+            column = source.GetColumn(loc.offset);
+        });
+
+        return column;
+    }
+
+    SourceBufferBase::~SourceBufferBase() {
+        Slot* slot = GetSlot(id);
+
+        if (slot) {
+            slot->source.store(nullptr);
+            while (slot->readers.load())
+                std::this_thread::yield();
+
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.free.push_back(id & slot_mask);
+        }
+
+#ifdef unix
+        if (mapping)
+            munmap(mapping, mapping_size);
+#endif
+    }
+
+    SourceBuffer SourceBufferBase::FromString(std::string_view code) {
+        SourceBuffer source = Create();
+
+        source->heap = std::unique_ptr<char[]>(new char[code.length() + padding]());
+        std::memcpy(source->heap.get(), code.data(), code.length());
+
+        source->data = source->heap.get();
+        source->size = code.length();
+
+        return source;
+    }
+
+    SourceBuffer SourceBufferBase::FromEdit(const SourceBufferBase& source, size_t offset, size_t removed, std::string_view inserted) {
+        SourceBuffer edited = Create();
+        size_t tail = source.size - offset - removed;
+
+        edited->size = offset + inserted.length() + tail;
+        edited->heap = std::unique_ptr<char[]>(new char[edited->size + padding]());
+
+        std::memcpy(edited->heap.get(), source.data, offset);
+        std::memcpy(edited->heap.get() + offset, inserted.data(), inserted.length());
+        std::memcpy(edited->heap.get() + offset + inserted.length(), source.data + offset + removed, tail);
+
+        edited->data = edited->heap.get();
+
+        return edited;
+    }
+
+#ifdef unix
+    bool SourceBufferBase::ReadStream(int fd) {
+        size_t capacity = 1 << 16;
+        size_t length = 0;
+        std::unique_ptr<char[]> buffer(new char[capacity + padding]);
+
+        while (true) {
+            if (length == capacity) {
+                std::unique_ptr<char[]> grown(new char[capacity * 2 + padding]);
+                std::memcpy(grown.get(), buffer.get(), length);
+
+                buffer = std::move(grown);
+                capacity *= 2;
+            }
+
+            ssize_t count = read(fd, buffer.get() + length, capacity - length);
+            if (count < 0)
+                return false;
+
+            else if (count == 0)
+                break;
+
+            length += count;
+        }
+
+        std::memset(buffer.get() + length, 0, padding);
+
+        heap = std::move(buffer);
+        data = heap.get();
+        size = length;
+
+        return true;
+    }
+
+    SourceBuffer SourceBufferBase::FromFile(const std::string& path, std::string& error_msg) {
+        SourceBuffer source = Create();
+
+        if (path == "-") {
+            if (!source->ReadStream(STDIN_FILENO)) {
+                error_msg = "Could not read stdin";
+                return nullptr;
+            }
+
+            return source;
+        }
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error_msg = Format("Could not open file: $", path);
+            return nullptr;
+        }
+
+        struct stat info;
+        if ((fstat(fd, &info) == 0) && S_ISREG(info.st_mode) && (info.st_size > 0)) {
+            size_t length = info.st_size;
+            size_t page = sysconf(_SC_PAGESIZE);
+            size_t total = ((length + padding + page - 1) / page) * page;
+
+            // Reserve zeroed pages for the file and its padding, then map the
+            // file over the front so the padding stays readable zeros
+            void* region = mmap(nullptr, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region != MAP_FAILED) {
+                void* file = mmap(region, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+
+                if (file != MAP_FAILED) {
+                    close(fd);
+
+                    source->mapping = region;
+                    source->mapping_size = total;
+                    source->mapped = true;
+                    source->data = (const char*)region;
+                    source->size = length;
+
+                    return source;
+                }
+
+                munmap(region, total);
+            }
+        }
+
+        bool read = source->ReadStream(fd);
+        close(fd);
+
+        if (!read) {
+            error_msg = Format("Could not read file: $", path);
+            return nullptr;
+        }
+
+        return source;
+    }
+
+#else
+    SourceBuffer SourceBufferBase::FromFile(const std::string& path, std::string& error_msg) {
+        std::string code;
+
+        if (path == "-") {
+            code.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+            return FromString(code);
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            error_msg = Format("Could not open file: $", path);
+            return nullptr;
+        }
+
+        code.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        return FromString(code);
+    }
+
+#endif
+
+}
@@ -1,88 +1,156 @@
 #include "strhelper.hpp"
+#include "scanner.hpp"
 
 namespace Martin::StrHelper {
 
-    bool IsFirstMatch(const void* string_ptr, const void* first_ptr) {
-        const uint8_t* string = (const uint8_t*)string_ptr;
-        const uint8_t* first = (const uint8_t*)first_ptr;
+    static bool IsZeroUnit(const uint8_t* data, size_t unit) {
+        for (size_t i = 0; i < unit; i++) {
+            if (data[i] != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool IsFirstMatch(std::string_view in, const char* first) {
+        size_t i = 0;
         
         while (true) {
-            if (*first == '\0')
+            if (first[i] == '\0')
                 return true;
             
-            else if (*string == '\0')
+            else if (i >= in.length())
                 return false;
             
-            else if (*first++ != *string++)
+            else if (first[i] != in[i])
                 return false;
+            
+            i++;
         }
     }
 
-    bool IsMatch(const std::string& in) {
+    bool IsMatch(std::string_view in) {
+        if (in.length() == 0)
+            return false;
+
         char delim = in[0];
 
-        if ((delim != '\'') && (delim != '\"') && (delim != '`'))
-            return false;
-        
+        return (delim == '\'') || (delim == '\"') || (delim == '`');
+    }
+
+    size_t Process(LexerState& state, std::string_view in, size_t prefix, TokenRecord& record, TokenBufferBase& buffer, TokenType::Type kind) {
+        in.remove_prefix(prefix);
+
+        char delim = in[0];
+
+        // Only stop on the delimiter or a backslash, escapes are decoded later
+        size_t i = 1;
+        while (true) {
+            i = Scanner::FindEither(in, i, delim, '\\');
+            if (i == std::string_view::npos)
+                return 0;
 
-        for (size_t i = 1; i < in.length(); i++) {
             if (in[i] == delim)
-                return true;
-            
-            else if (in[i] == '\\')
-                i++;
+                break;
+
+            i += 2;
         }
 
-        return false;
+        record.kind = (uint32_t)kind;
+        record.payload = buffer.AddLiteral();
+
+        // Prefix, opening delimiter, contents and closing delimiter
+        return prefix + i + 1;
     }
 
-    std::shared_ptr<uint8_t[]> Process(std::string& in, UnicodeType utype) {
-        char delim = in[0];
-        in.erase(0, 1);
-        
+    static UnicodeType GetUnicodeType(TokenType::Type kind) {
+        switch (kind) {
+            case TokenType::Type::String16:
+                return UnicodeType_16Bits;
+            
+            case TokenType::Type::String32:
+                return UnicodeType_32Bits;
+            
+            case TokenType::Type::String16l:
+                return UnicodeType_16BitsLittle;
+            
+            case TokenType::Type::String16b:
+                return UnicodeType_16BitsBig;
+            
+            case TokenType::Type::String32l:
+                return UnicodeType_32BitsLittle;
+            
+            case TokenType::Type::String32b:
+                return UnicodeType_32BitsBig;
+            
+            default:
+                return UnicodeType_8Bits;
+        }
+    }
+
+    std::unique_ptr<uint8_t[]> Decode(std::string_view span, TokenType::Type kind, size_t& size) {
+        // Skip the encoding prefix, the span always ends on the closing delimiter
+        size_t start = span.find_first_of("\'\"`");
+        std::string_view in = span.substr(start + 1, span.length() - start - 2);
         std::string str = "";
 
+        // Copy the runs between escapes in one go
         size_t i = 0;
-        for (; i < in.length(); i++) {
-            if (in[i] == delim)
+        while (i < in.length()) {
+            size_t next = Scanner::Find(in, i, '\\');
+            if (next == std::string_view::npos)
+                next = in.length();
+
+            str.append(in.data() + i, next - i);
+            i = next + 1;
+
+            if (i >= in.length())
                 break;
+
+            else if (in[i] == 'n')
+                str += '\n';
+            
+            else if (in[i] == 'r')
+                str += '\r';
+            
+            else if (in[i] == 't')
+                str += '\t';
+            
+            else if (in[i] == '0')
+                str += '\0';
+            
+            else if (in[i] == '\'')
+                str += '\'';
+            
+            else if (in[i] == '\"')
+                str += '\"';
             
-            else if (in[i] == '\\') {
-                i++;
-
-                if (in[i] == 'n')
-                    str += '\n';
-                
-                else if (in[i] == 'r')
-                    str += '\r';
-                
-                else if (in[i] == 't')
-                    str += '\t';
-                
-                else if (in[i] == '0')
-                    str += '\0';
-                
-                else if (in[i] == '\'')
-                    str += '\'';
-                
-                else if (in[i] == '\"')
-                    str += '\"';
-                
-                else if (in[i] == '`')
-                    str += '`';
-                
-                //else
-                    // Todo: Error here
-
-            } else
-                str += in[i];
+            else if (in[i] == '`')
+                str += '`';
+            
+            //else
+                // Todo: Error here
+
+            i++;
         }
 
-        in.erase(0, i + 1);
+        UnicodeType utype = GetUnicodeType(kind);
 
         const uint8_t* c_str = (const uint8_t*)str.c_str();
+        std::unique_ptr<uint8_t[]> converted(unicode_convert(c_str, UnicodeType_8Bits, utype));
+
+        size_t unit = 1;
+        if ((utype == UnicodeType_16BitsLittle) || (utype == UnicodeType_16BitsBig))
+            unit = 2;
         
-        return std::shared_ptr<uint8_t[]>(unicode_convert(c_str, UnicodeType_8Bits, utype));
+        else if ((utype == UnicodeType_32BitsLittle) || (utype == UnicodeType_32BitsBig))
+            unit = 4;
+
+        size = 0;
+        while (!IsZeroUnit(converted.get() + size, unit))
+            size += unit;
+
+        return converted;
     }
 
 }
\ No newline at end of file
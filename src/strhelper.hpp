@@ -2,17 +2,28 @@
 #define MARTIN_STR_HELPER
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <stdint.h>
 #include <unicode.hpp>
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
 
 namespace Martin::StrHelper {
 
-    bool IsFirstMatch(const void* string, const void* first);
+    bool IsFirstMatch(std::string_view in, const char* first);
 
-    bool IsMatch(const std::string& in);
-    std::shared_ptr<uint8_t[]> Process(std::string& in, UnicodeType utype);
+    // Only checks for an opening delimiter, Process finds the closing one
+    bool IsMatch(std::string_view in);
+    // Finds the end of the literal following a prefix of the given length
+    // and returns how many bytes it spans, prefix and delimiters included,
+    // or 0 when the literal is never closed. Decoding waits for Decode
+    size_t Process(LexerState& state, std::string_view in, size_t prefix, TokenRecord& record, TokenBufferBase& buffer, TokenType::Type kind);
+
+    // Decodes the escapes of a literal's span and converts it to the kind's
+    // encoding. size is set to the byte length without the zero terminator
+    std::unique_ptr<uint8_t[]> Decode(std::string_view span, TokenType::Type kind, size_t& size);
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,306 @@
+#include <tokenbuffer.hpp>
+
+#include <logging.hpp>
+
+#include "fixedtokens.hpp"
+#include "strhelper.hpp"
+#include "literals.hpp"
+
+#define FixedTokenName(pname, type, str)\
+    case TokenType::Type::type:\
+        return str;
+
+namespace Martin {
+
+    class BufferTokenType;
+
+    // A list's tokens all point into one array of views, which is kept alive
+    // together with the buffer for as long as any token or its data is
+    struct TokenViews : public std::enable_shared_from_this<TokenViews> {
+        TokenBuffer buffer;
+        std::vector<BufferTokenType> tokens;
+    };
+
+    class BufferTokenType : public TokenType {
+    public:
+        Type GetType() const override {
+            return buffer->GetType(index);
+        }
+
+        std::shared_ptr<void> GetData() override {
+            switch (GetType()) {
+                case Type::FloatingSingle:
+                    return std::shared_ptr<void>(views->shared_from_this(), (void*)&buffer->GetValue(index).single);
+                
+                case Type::FloatingDouble:
+                    return std::shared_ptr<void>(views->shared_from_this(), (void*)&buffer->GetValue(index).floating);
+                
+                case Type::UInteger:
+                    return std::shared_ptr<void>(views->shared_from_this(), (void*)&buffer->GetValue(index).uinteger);
+                
+                case Type::Integer:
+                    return std::shared_ptr<void>(views->shared_from_this(), (void*)&buffer->GetValue(index).integer);
+                
+                case Type::String8:
+                case Type::String16:
+                case Type::String32:
+                case Type::String16l:
+                case Type::String16b:
+                case Type::String32l:
+                case Type::String32b:
+                case Type::Identifier:
+                    return std::shared_ptr<void>(views->shared_from_this(), (void*)buffer->GetBytes(index));
+                
+                default:
+                    return nullptr;
+            }
+        }
+
+        std::string GetName() const override {
+            return buffer->GetName(index);
+        }
+
+        Symbol GetSymbol() const override {
+            return buffer->GetSymbol(index);
+        }
+
+        const TokenViews* views;
+        const TokenBufferBase* buffer;
+        size_t index;
+    };
+
+    static bool IsStringKind(TokenType::Type type) {
+        switch (type) {
+            case TokenType::Type::String8:
+            case TokenType::Type::String16:
+            case TokenType::Type::String32:
+            case TokenType::Type::String16l:
+            case TokenType::Type::String16b:
+            case TokenType::Type::String32l:
+            case TokenType::Type::String32b:
+                return true;
+            
+            default:
+                return false;
+        }
+    }
+
+    static bool IsLiteralKind(TokenType::Type type) {
+        switch (type) {
+            case TokenType::Type::FloatingSingle:
+            case TokenType::Type::FloatingDouble:
+            case TokenType::Type::UInteger:
+            case TokenType::Type::Integer:
+                return true;
+            
+            default:
+                return IsStringKind(type);
+        }
+    }
+
+    const TokenBufferBase::Literal& TokenBufferBase::GetLiteral(size_t index) const {
+        std::lock_guard<std::mutex> lock(literal_mutex);
+
+        Literal& literal = literals[records[index].payload];
+        if (literal.decoded)
+            return literal;
+
+        TokenType::Type type = GetType(index);
+        std::string_view span = GetSpan(index);
+
+        if (IsStringKind(type)) {
+            size_t size;
+            auto decoded = StrHelper::Decode(span, type, size);
+
+            if (type == TokenType::Type::String8)
+                literal.symbol = InternerSingleton.Intern(std::string_view((const char*)decoded.get(), size));
+            
+            else
+                literal.bytes = std::move(decoded);
+        } else {
+            // Literals that overflow were reported when they were lexed
+            Literals::DecodeNumber(type, span, literal.value);
+        }
+
+        literal.decoded = true;
+        return literal;
+    }
+
+    const TokenValue& TokenBufferBase::GetValue(size_t index) const {
+        return GetLiteral(index).value;
+    }
+
+    const uint8_t* TokenBufferBase::GetBytes(size_t index) const {
+        Symbol symbol = GetSymbol(index);
+        if (symbol != InvalidSymbol)
+            return (const uint8_t*)InternerSingleton.GetSpelling(symbol).data();
+
+        return GetLiteral(index).bytes.get();
+    }
+
+    Symbol TokenBufferBase::GetSymbol(size_t index) const {
+        switch (GetType(index)) {
+            case TokenType::Type::Identifier:
+                return records[index].payload;
+            
+            case TokenType::Type::String8:
+                return GetLiteral(index).symbol;
+            
+            default:
+                return InvalidSymbol;
+        }
+    }
+
+    std::string_view TokenBufferBase::GetSpan(size_t index) const {
+        const TokenRecord& record = records[index];
+        return GetSource().substr(record.offset, record.length);
+    }
+
+    std::string TokenBufferBase::GetName(size_t index) const {
+        switch (GetType(index)) {
+            MARTIN_FIXED_TOKENS(FixedTokenName, FixedTokenName)
+
+            case TokenType::Type::KW_Array:
+                return "array ";
+            
+            case TokenType::Type::FloatingSingle:
+                return std::string("FloatingSingle ") + std::to_string(GetValue(index).single);
+            
+            case TokenType::Type::FloatingDouble:
+                return std::string("FloatingDouble ") + std::to_string(GetValue(index).floating);
+            
+            case TokenType::Type::UInteger:
+                return std::string("UInteger ") + std::to_string(GetValue(index).uinteger);
+            
+            case TokenType::Type::Integer:
+                return std::string("Integer ") + std::to_string(GetValue(index).integer);
+            
+            case TokenType::Type::Boolean:
+                return std::string("Boolean ") + (records[index].payload ? "true" : "false");
+            
+            case TokenType::Type::String8:
+                return std::string("String8 ") + (const char*)GetBytes(index);
+            
+            case TokenType::Type::String16:
+                return "String16";
+            
+            case TokenType::Type::String32:
+                return "String32";
+            
+            case TokenType::Type::String16l:
+                return "String16l";
+            
+            case TokenType::Type::String16b:
+                return "String16b";
+            
+            case TokenType::Type::String32l:
+                return "String32l";
+            
+            case TokenType::Type::String32b:
+                return "String32b";
+            
+            case TokenType::Type::Identifier:
+                return std::string("Identifier ") + (const char*)GetBytes(index);
+            
+            default:
+                return "Unknown";
+        }
+    }
+
+    void TokenBufferBase::Append(TokenBufferBase& other) {
+        uint32_t literal_offset = (uint32_t)literals.size();
+        size_t start = records.size();
+
+        records.insert(records.end(), other.records.begin(), other.records.end());
+        literals.insert(literals.end(), std::make_move_iterator(other.literals.begin()), std::make_move_iterator(other.literals.end()));
+
+        for (size_t i = start; i < records.size(); i++) {
+            if (IsLiteralKind(GetType(i)))
+                records[i].payload += literal_offset;
+        }
+
+        other.records.clear();
+        other.literals.clear();
+    }
+
+    void TokenBufferBase::AppendShifted(const TokenBufferBase& other, size_t begin, size_t end, ptrdiff_t shift) {
+        std::lock_guard<std::mutex> lock(other.literal_mutex);
+
+        for (size_t i = begin; i < end; i++) {
+            TokenRecord record = other.records[i];
+            record.offset = (uint32_t)(record.offset + shift);
+
+            if (IsLiteralKind(other.GetType(i))) {
+                const Literal& from = other.literals[record.payload];
+                record.payload = AddLiteral();
+
+                if (from.decoded && !from.bytes) {
+                    Literal& to = literals.back();
+                    to.decoded = true;
+                    to.value = from.value;
+                    to.symbol = from.symbol;
+                }
+            }
+
+            Push(record);
+        }
+    }
+
+    void TokenBufferBase::Reserve(size_t count) {
+        records.reserve(count);
+    }
+
+    void TokenBufferBase::Push(const TokenRecord& record) {
+        records.push_back(record);
+    }
+
+    void TokenBufferBase::Push(const TokenRecord* records, size_t count) {
+        this->records.insert(this->records.end(), records, records + count);
+    }
+
+    void TokenBufferBase::ReserveLiterals(size_t count) {
+        literals.reserve(count);
+    }
+
+    uint32_t TokenBufferBase::AddLiteral() {
+        literals.emplace_back();
+        return (uint32_t)(literals.size() - 1);
+    }
+
+    uint32_t TokenBufferBase::AddLiteral(const TokenValue& value) {
+        Literal& literal = literals.emplace_back();
+        literal.decoded = true;
+        literal.value = value;
+
+        return (uint32_t)(literals.size() - 1);
+    }
+
+    TokenList CreateTokenList(TokenBuffer buffer) {
+        if (!buffer)
+            Fatal("Trying to create a token list from a nullptr token buffer\n");
+
+        auto views = std::make_shared<TokenViews>();
+        views->buffer = buffer;
+        views->tokens.resize(buffer->Size());
+
+        TokenList list = TokenList(new std::vector<Token>);
+        list->reserve(buffer->Size());
+
+        FileID file = buffer->GetSourceBuffer()->GetFileID();
+
+        for (size_t i = 0; i < buffer->Size(); i++) {
+            BufferTokenType& token = views->tokens[i];
+            const TokenRecord& record = buffer->GetRecord(i);
+
+            token.views = views.get();
+            token.buffer = buffer.get();
+            token.index = i;
+            token.SetLocation({ file, record.offset }, record.length);
+
+            list->push_back(Token(views, &token));
+        }
+
+        return list;
+    }
+
+}
@@ -0,0 +1,333 @@
+#include <tokencache.hpp>
+
+#include <tokenbuffer.hpp>
+#include <versions.hpp>
+#include <platform.hpp>
+#include <hash.hpp>
+#include <logging.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#ifdef unix
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Martin {
+
+    static const char entry_magic[8] = { 'M', 'T', 'O', 'K', 'E', 'N', 'S', 0 };
+
+    // Followed by the records, number values, spelling lengths and
+    // spellings. Identifier payloads index the spellings
+    struct EntryHeader {
+        char magic[8];
+        uint32_t format;
+        uint32_t compiler[4];
+        uint32_t reserved;
+
+        uint64_t hash;
+        // Second hash of the source with another seed, so an entry whose
+        // hash collides with the source's isn't taken for it
+        uint64_t check;
+        uint64_t source_size;
+
+        uint64_t token_count;
+        uint64_t value_count;
+        uint64_t spelling_count;
+        uint64_t spelling_bytes;
+    };
+
+    static bool IsNumberKind(TokenType::Type type) {
+        switch (type) {
+            case TokenType::Type::FloatingSingle:
+            case TokenType::Type::FloatingDouble:
+            case TokenType::Type::UInteger:
+            case TokenType::Type::Integer:
+                return true;
+            
+            default:
+                return false;
+        }
+    }
+
+    static bool IsStringKind(TokenType::Type type) {
+        switch (type) {
+            case TokenType::Type::String8:
+            case TokenType::Type::String16:
+            case TokenType::Type::String32:
+            case TokenType::Type::String16l:
+            case TokenType::Type::String16b:
+            case TokenType::Type::String32l:
+            case TokenType::Type::String32b:
+                return true;
+            
+            default:
+                return false;
+        }
+    }
+
+    static const uint64_t check_seed = 0x9E3779B97F4A7C15;
+
+    static void FillHeaderVersion(EntryHeader& header) {
+        std::memcpy(header.magic, entry_magic, sizeof(entry_magic));
+        header.format = TokenCache::format;
+        header.compiler[0] = CompilerVersion.major;
+        header.compiler[1] = CompilerVersion.minor;
+        header.compiler[2] = CompilerVersion.patch;
+        header.compiler[3] = (uint32_t)CompilerVersion.level;
+        header.reserved = 0;
+    }
+
+    // Builds the buffer from an entry's bytes, nullptr when they don't fit source
+    static TokenBuffer ReadEntry(const char* data, size_t size, SourceBuffer source, uint64_t key) {
+        EntryHeader header;
+        if (size < sizeof(header))
+            return nullptr;
+
+        std::memcpy(&header, data, sizeof(header));
+
+        EntryHeader expected;
+        FillHeaderVersion(expected);
+
+        if (
+            (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) ||
+            (header.format != expected.format) ||
+            (std::memcmp(header.compiler, expected.compiler, sizeof(header.compiler)) != 0) ||
+            (header.hash != key) || (header.source_size != source->GetSize()) ||
+            (header.check != Hash64(source->GetView(), check_seed))
+        )
+            return nullptr;
+
+        // Every part has to fit in the bytes after the header on its own, so
+        // counts from a damaged header can't overflow the sizes
+        size_t body = size - sizeof(header);
+        if (
+            (header.token_count > body / sizeof(TokenRecord)) ||
+            (header.value_count > body / sizeof(TokenValue)) ||
+            (header.spelling_count > body / sizeof(uint32_t)) ||
+            (header.spelling_bytes > body)
+        )
+            return nullptr;
+
+        size_t records_size = header.token_count * sizeof(TokenRecord);
+        size_t values_size = header.value_count * sizeof(TokenValue);
+        size_t lengths_size = header.spelling_count * sizeof(uint32_t);
+
+        if (size != sizeof(header) + records_size + values_size + lengths_size + header.spelling_bytes)
+            return nullptr;
+
+        const char* record_data = data + sizeof(header);
+        const char* values = record_data + records_size;
+        const char* lengths = values + values_size;
+        const char* spellings = lengths + lengths_size;
+
+        // Symbols only mean something within one run, so the spellings get
+        // interned again, once each
+        std::vector<Symbol> symbols(header.spelling_count);
+        size_t spelling_offset = 0;
+
+        for (size_t i = 0; i < header.spelling_count; i++) {
+            uint32_t length;
+            std::memcpy(&length, lengths + i * sizeof(length), sizeof(length));
+
+            if (spelling_offset + length > header.spelling_bytes)
+                return nullptr;
+
+            symbols[i] = InternerSingleton.Intern(std::string_view(spellings + spelling_offset, length));
+            spelling_offset += length;
+        }
+
+        std::vector<TokenRecord> records(header.token_count);
+        std::memcpy(records.data(), record_data, records_size);
+
+        TokenBuffer buffer = TokenBuffer(new TokenBufferBase(source));
+        buffer->ReserveLiterals(header.value_count);
+
+        size_t value_index = 0;
+
+        for (TokenRecord& record : records) {
+            if (((uint64_t)record.offset + record.length > source->GetSize()) || (record.kind >= TokenType::TypeCount))
+                return nullptr;
+
+            TokenType::Type type = (TokenType::Type)record.kind;
+
+            if (type == TokenType::Type::Identifier) {
+                if (record.payload >= symbols.size())
+                    return nullptr;
+
+                record.payload = symbols[record.payload];
+            } else if (IsNumberKind(type)) {
+                if (value_index >= header.value_count)
+                    return nullptr;
+
+                TokenValue value;
+                std::memcpy(&value, values + (value_index++) * sizeof(value), sizeof(value));
+                record.payload = buffer->AddLiteral(value);
+            } else if (IsStringKind(type))
+                record.payload = buffer->AddLiteral();
+        }
+
+        buffer->Push(records.data(), records.size());
+
+        return buffer;
+    }
+
+    TokenCache::TokenCache(const std::string& directory) : directory(directory) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        if (error)
+            Warning("Could not create the token cache directory $: $\n", directory, error.message());
+    }
+
+    uint64_t TokenCache::GetKey(std::string_view source) {
+        uint32_t version[5] = { format, CompilerVersion.major, CompilerVersion.minor, CompilerVersion.patch, (uint32_t)CompilerVersion.level };
+
+        uint64_t seed = Hash64(std::string_view((const char*)version, sizeof(version)));
+        return Hash64(source, seed);
+    }
+
+    std::string TokenCache::GetEntryPath(uint64_t key) const {
+        static const char digits[] = "0123456789abcdef";
+
+        std::string name(16, '0');
+        for (size_t i = 0; i < 16; i++)
+            name[15 - i] = digits[(key >> (i * 4)) & 0xF];
+
+        return directory + "/" + name + ".tokens";
+    }
+
+    TokenBuffer TokenCache::Tokenize(SourceBuffer source) {
+        TokenBuffer buffer = Load(source);
+        if (buffer)
+            return buffer;
+
+        buffer = TokenizerSingleton.TokenizeParallel(source);
+        Store(*buffer);
+
+        return buffer;
+    }
+
+    TokenBuffer TokenCache::Load(SourceBuffer source) const {
+        uint64_t key = GetKey(source->GetView());
+        std::string path = GetEntryPath(key);
+
+#ifdef unix
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+
+        struct stat info;
+        if ((fstat(fd, &info) != 0) || (info.st_size == 0)) {
+            close(fd);
+            return nullptr;
+        }
+
+        void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+            return nullptr;
+
+        TokenBuffer buffer = ReadEntry((const char*)mapping, info.st_size, source, key);
+        munmap(mapping, info.st_size);
+
+        return buffer;
+#else
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return nullptr;
+
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return ReadEntry(data.data(), data.size(), source, key);
+#endif
+    }
+
+    bool TokenCache::Store(const TokenBufferBase& buffer) const {
+        std::string_view source = buffer.GetSource();
+
+        EntryHeader header;
+        FillHeaderVersion(header);
+        header.hash = GetKey(source);
+        header.check = Hash64(source, check_seed);
+        header.source_size = source.length();
+        header.token_count = buffer.Size();
+
+        std::vector<TokenRecord> records(buffer.Size());
+        std::vector<TokenValue> values;
+
+        std::unordered_map<Symbol, uint32_t> spelling_indices;
+        std::vector<uint32_t> lengths;
+        std::string spellings;
+
+        for (size_t i = 0; i < buffer.Size(); i++) {
+            TokenRecord record = buffer.GetRecord(i);
+            TokenType::Type type = buffer.GetType(i);
+
+            if (type == TokenType::Type::Identifier) {
+                auto [entry, added] = spelling_indices.emplace(record.payload, (uint32_t)lengths.size());
+                if (added) {
+                    std::string_view spelling = InternerSingleton.GetSpelling(record.payload);
+                    lengths.push_back((uint32_t)spelling.length());
+                    spellings.append(spelling);
+                }
+
+                record.payload = entry->second;
+            } else if (IsNumberKind(type)) {
+                values.push_back(buffer.GetValue(i));
+                record.payload = 0;
+            } else if (IsStringKind(type))
+                record.payload = 0;
+
+            records[i] = record;
+        }
+
+        header.value_count = values.size();
+        header.spelling_count = lengths.size();
+        header.spelling_bytes = spellings.length();
+
+        // Written next to the entry and renamed over it, so readers never see half of one
+        std::string path = GetEntryPath(header.hash);
+        size_t unique = std::hash<std::thread::id>()(std::this_thread::get_id()) ^ (size_t)std::chrono::steady_clock::now().time_since_epoch().count();
+        std::string temporary = path + "." + std::to_string(unique) + ".tmp";
+
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+
+            file.write((const char*)&header, sizeof(header));
+            file.write((const char*)records.data(), records.size() * sizeof(TokenRecord));
+            file.write((const char*)values.data(), values.size() * sizeof(TokenValue));
+            file.write((const char*)lengths.data(), lengths.size() * sizeof(uint32_t));
+            file.write(spellings.data(), spellings.length());
+
+            if (!file.good()) {
+                file.close();
+
+                std::error_code ignored;
+                std::filesystem::remove(temporary, ignored);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+
+        return true;
+    }
+
+}
@@ -1,4 +1,5 @@
 #include <tokens.hpp>
+#include <tokenbuffer.hpp>
 
 #include <iostream>
 #include <stdint.h>
@@ -6,27 +7,20 @@
 #include <algorithm>
 
 #include <logging.hpp>
+#include <parallel.hpp>
+#include <interner.hpp>
+#include <numbers.hpp>
 
 #include "strhelper.hpp"
+#include "scanner.hpp"
+#include "fixedtokens.hpp"
 
 
-#define FixedToken(name, pname, type, str)\
-    class name : public TokenType {\
-    public:\
-        Type GetType() const override {\
-            return type;\
-        }\
-        void Process(std::string& in) override {\
-            in.erase(0, std::strlen(str));\
-        }\
-        std::string GetName() const override {\
-            return str;\
-        }\
-    };\
+#define FixedToken(pname, type, str)\
     class pname : public PatternType {\
     public:\
-        bool IsMatch(const std::string& in) const override {\
-            if (!StrHelper::IsFirstMatch(in.c_str(), str)) return false;\
+        bool IsMatch(std::string_view in) const override {\
+            if (!StrHelper::IsFirstMatch(in, str)) return false;\
             if (in.length() >= sizeof(str)) {\
                 char c = in[sizeof(str) - 1];\
                 if ((c >= 'a') && (c <= 'z')) return false;\
@@ -35,36 +29,43 @@
             }\
             return true;\
         }\
-        Token CreateToken() const override {\
-            return Token(new name);\
+        bool CanStartWith(char c) const override {\
+            return c == str[0];\
+        }\
+        const char* GetFixed() const override {\
+            return str;\
+        }\
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {\
+            record.kind = (uint32_t)TokenType::Type::type;\
+            return std::strlen(str);\
         }\
     };
 
-#define FixedTokenSYM(name, pname, type, str)\
-    class name : public TokenType {\
+#define FixedTokenSYM(pname, type, str)\
+    class pname : public PatternType {\
     public:\
-        Type GetType() const override {\
-            return type;\
+        bool IsMatch(std::string_view in) const override {\
+            return StrHelper::IsFirstMatch(in, str);\
         }\
-        void Process(std::string& in) override {\
-            in.erase(0, std::strlen(str));\
+        bool CanStartWith(char c) const override {\
+            return c == str[0];\
         }\
-        std::string GetName() const override {\
+        const char* GetFixed() const override {\
             return str;\
         }\
-    };\
-    class pname : public PatternType {\
-    public:\
-        bool IsMatch(const std::string& in) const override {\
-            return StrHelper::IsFirstMatch(in.c_str(), str);\
-        }\
-        Token CreateToken() const override {\
-            return Token(new name);\
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {\
+            record.kind = (uint32_t)TokenType::Type::type;\
+            return std::strlen(str);\
         }\
     };
 
+#define RegisterFixedToken(pname, type, str)\
+    patterns.push_back(Pattern(new pname));
+
 namespace Martin {
-    unsigned int line_number = 1;
+
+    // Upper bound on the length of a keyword or symbol spelling
+    static const size_t max_fixed_length = 16;
 
     enum class NumberType {
         Decimal,
@@ -73,519 +74,99 @@ namespace Martin {
         Binary
     };
 
-    class NewLineToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::Ignore;
-        }
-
-        void Process(std::string& in) override {
-            in.erase(0, 1);
-
-            line_number++;
-        }
-    };
-
-    class WhiteSpaceToken : public TokenType {
-        Type GetType() const override {
-            return Type::Ignore;
-        }
-
-        void Process(std::string& in) override {
-            in.erase(0, 1);
-        }
-    };
-
-    class CommentSingleLineToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::Ignore;
-        }
-
-        void Process(std::string& in) override {
-            size_t i = 0;
-            for (; i < in.length(); i++) {
-                if (in[i] == '\n')
-                    break;
-            }
-
-            in.erase(0, i);
-        }
-    };
-
-    class CommentMultiLineToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::Ignore;
-        }
-
-        void Process(std::string& in) override {
-            size_t i = 2;
-            for (; i < in.length(); i++) {
-                if ((in[i-1] == '*') && (in[i] == '/'))
-                    break;
-                
-                else if (in[i] == '\n')
-                    line_number++;
-            }
-
-            in.erase(0, i + 1);
-        }
-    };
-
-    class FloatingSingleToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::FloatingSingle;
-        }
-
-        void Process(std::string& in) override {
-            size_t index = in.find("f");
-            std::string float_str = in.substr(0, index);
-            in.erase(0, index+1);
-            value = std::stof(float_str);
-        }
-
-        std::shared_ptr<void> GetData() override {
-            return std::make_shared<float>(value);
-        }
-
-        std::string GetName() const override {
-            return std::string("FloatingSingle ") + std::to_string(value);
-        }
-
-    private:
-        float value = 0.0f;
-    };
-
-    class FloatingDoubleToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::FloatingDouble;
-        }
-
-        void Process(std::string& in) override {
-            size_t index = in.find_first_not_of("-1234567890.");
-            std::string double_str = in.substr(0, index);
-            in.erase(0, index);
-            value = std::stod(double_str);
-        }
-
-        std::shared_ptr<void> GetData() override {
-            return std::make_shared<double>(value);
-        }
-
-        std::string GetName() const override {
-            return std::string("FloatingDouble ") + std::to_string(value);
-        }
-
-    private:
-        double value = 0.0f;
-    };
-
-    class UIntegerToken : public TokenType {
-    public:
-        Type GetType() const override { return Type::UInteger; }
-
-        void Process(std::string& in) override {
-            NumberType type = NumberType::Decimal;
-            char c;
-
-            in.erase(0, 1);
-            
-            if (in.length() >= 1) {
-                switch (in[0]) {
-                    case 'x':
-                    case 'X':
-                        type = NumberType::Hexidecimal;
-                        in.erase(0, 1);
-                        break;
-                    case 'o':
-                    case 'O':
-                        type = NumberType::Octal;
-                        in.erase(0, 1);
-                        break;
-                    case 'b':
-                    case 'B':
-                        type = NumberType::Binary;
-                        in.erase(0, 1);
-                        break;
-                }
-            }
-
-            while (true) {
-                if (in.length() >= 1) {
-                    c = in[0];
-
-                    switch (type) {
-                        case NumberType::Hexidecimal:
-                            if (c != '_') {
-                                value *= 16;
-                                if ((c >= '0') && (c < '9'))
-                                    value += c - '0';
-                            
-                                else if ((c >= 'a') && (c <= 'f'))
-                                    value += c - 'a' + 10;
-                            
-                                else if ((c >= 'A') && (c <= 'F'))
-                                    value += c - 'A' + 10;
-                                
-                                else {
-                                    value /= 16;
-                                    return;
-                                }
-                            }
-                            
-                            break;
-                        
-                        case NumberType::Octal:
-                            if (c != '_') {
-                                value *= 8;
-                                if ((c >= '0') && (c <= '7'))
-                                    value += c - '0';
-                                
-                                else {
-                                    value /= 8;
-                                    return;
-                                }
-                            }
-                            
-                            break;
-                        
-                        case NumberType::Decimal:
-                            if (c != '_') {
-                                value *= 10;
-                                if ((c >= '0') && (c <= '9'))
-                                    value += c - '0';
-                                
-                                else {
-                                    value /= 10;
-                                    return;
-                                }
-                            }
-
-                            break;
-                            
-                        case NumberType::Binary:
-                            if (c != '_') {
-                                value *= 2;
-                                if ((c == '0') || (c == '1'))
-                                    value += c - '0';
-                                
-                                else {
-                                    value /= 2;
-                                    return;
-                                }
-                            }
-                            
-                            break;
-                    }
-
-                    in.erase(0, 1);
-                    
-                } else {
-                    break;
-                }
-            }
-
-        }
-    
-        std::shared_ptr<void> GetData() override { return std::make_shared<uintmax_t>(value); }
-
-        std::string GetName() const override {
-            return std::string("UInteger ") + std::to_string(value);
-        }
-
-    private:
-        uintmax_t value = 0;
-    };
-
-    class IntegerToken : public TokenType {
-    public:
-        Type GetType() const override { return Type::Integer; }
-
-        void Process(std::string& in) override {
-            char c;
-
-            bool negative = false;
-
-            if (in[0] == '-') {
-                negative = true;
-                in.erase(0, 1);
-            }
-
-            while (true) {
-                if (in.length() >= 1) {
-                    c = in[0];
-
-                    if (c != '_') {
-                        if ((c >= '0') && (c <= '9')) {
-                            value *= 10;
-                            value += c - '0';
-                        } else
-                            break;
-                    }
-
-                    in.erase(0, 1);
-                    
-                } else {
-                    break;
-                }
-            }
-
-            if (negative)
-                value = -value;
-        }
-    
-        std::shared_ptr<void> GetData() override { return std::make_shared<intmax_t>(value); }
-
-        std::string GetName() const override {
-            return std::string("Integer ") + std::to_string(value);
-        }
-
-    private:
-        intmax_t value = 0;
-    };
-
-    class BooleanToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::Boolean;
-        }
-
-        void Process(std::string& in) override {
-            if (in[0] == 't') {
-                value = true;
-                in.erase(0, std::strlen("true"));
-            } else {
-                value = false;
-                in.erase(0, std::strlen("false"));
-            }
-        }
-
-        std::string GetName() const override {
-            return std::string("Boolean ") + (value ? "true" : "false");
-        }
-
-    private:
-        bool value = false;
-    };
-
-    class String8Token : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::String8;
-        }
-
-        void Process(std::string& in) override {
-            if (in[0] == '8')
-                in.erase(0, 1);
-
-            value = StrHelper::Process(in, UnicodeType_8Bits);
-        }
-
-        std::shared_ptr<void> GetData() override {
-            return value;
-        }
-
-        std::string GetName() const override {
-            const char* str = (const char*)value.get();
-            return std::string("String8 ") + str;
-        }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
-    };
-
-    class String16Token : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::String16;
-        }
-
-        void Process(std::string& in) override {
-            in.erase(0, 2);
-            value = StrHelper::Process(in, UnicodeType_16Bits);
-        }
-
-        std::shared_ptr<void> GetData() override {
-            return value;
-        }
-
-        std::string GetName() const override {
-            return "String16";
-        }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
-    };
-
-    class String32Token : public TokenType {
+    class NewLinePattern : public PatternType {
     public:
-        Type GetType() const override {
-            return Type::String32;
-        }
-
-        void Process(std::string& in) override {
-            in.erase(0, 2);
-            value = StrHelper::Process(in, UnicodeType_32Bits);
+        bool IsMatch(std::string_view in) const override {
+            return in[0] == '\n';
         }
 
-        std::shared_ptr<void> GetData() override {
-            return value;
+        bool CanStartWith(char c) const override {
+            return c == '\n';
         }
 
-        std::string GetName() const override {
-            return "String32";
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            record.kind = (uint32_t)TokenType::Type::Ignore;
+            return 1;
         }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
     };
 
-    class String16lToken : public TokenType {
+    class WhiteSpacePattern : public PatternType {
     public:
-        Type GetType() const override {
-            return Type::String16l;
-        }
-
-        void Process(std::string& in) override {
-            in.erase(0, 3);
-            value = StrHelper::Process(in, UnicodeType_16BitsLittle);
+        bool IsMatch(std::string_view in) const override {
+            return (in[0] == ' ') || (in[0] == '\t') || (in[0] == '\r');
         }
 
-        std::shared_ptr<void> GetData() override {
-            return value;
+        bool CanStartWith(char c) const override {
+            return (c == ' ') || (c == '\t') || (c == '\r');
         }
 
-        std::string GetName() const override {
-            return "String16l";
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            record.kind = (uint32_t)TokenType::Type::Ignore;
+            return 1;
         }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
     };
 
-    class String32lToken : public TokenType {
+    class CommentSingleLinePattern : public PatternType {
     public:
-        Type GetType() const override {
-            return Type::String32l;
-        }
-
-        void Process(std::string& in) override {
-            in.erase(0, 3);
-            value = StrHelper::Process(in, UnicodeType_32BitsLittle);
-        }
-
-        std::shared_ptr<void> GetData() override {
-            return value;
-        }
-
-        std::string GetName() const override {
-            return "String16b";
-        }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
-    };
+        bool IsMatch(std::string_view in) const override {
+            if (in.length() < 2)
+                return false;
 
-    class String16bToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::String16b;
+            return (in[0] == '/') && (in[1] == '/');
         }
 
-        void Process(std::string& in) override {
-            in.erase(0, 3);
-            value = StrHelper::Process(in, UnicodeType_16BitsBig);
+        bool CanStartWith(char c) const override {
+            return c == '/';
         }
 
-        std::shared_ptr<void> GetData() override {
-            return value;
-        }
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t end = Scanner::Find(in, 2, '\n');
+            if (end == std::string_view::npos)
+                end = in.length();
 
-        std::string GetName() const override {
-            return "String16b";
+            record.kind = (uint32_t)TokenType::Type::Ignore;
+            return end;
         }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
     };
 
-    class String32bToken : public TokenType {
+    class CommentMultiLinePattern : public PatternType {
     public:
-        Type GetType() const override {
-            return Type::String32b;
-        }
+        // Only checks the opener, the terminator is found once by Process
+        bool IsMatch(std::string_view in) const override {
+            if (in.length() < 2)
+                return false;
 
-        void Process(std::string& in) override {
-            in.erase(0, 3);
-            value = StrHelper::Process(in, UnicodeType_32BitsBig);
+            return (in[0] == '/') && (in[1] == '*');
         }
 
-        std::shared_ptr<void> GetData() override {
-            return value;
+        bool CanStartWith(char c) const override {
+            return c == '/';
         }
 
-        std::string GetName() const override {
-            return "String32b";
-        }
+        // Returns 0 when the comment is never closed
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t i = 2;
+            size_t end = 0;
 
-    private:
-        std::shared_ptr<uint8_t[]> value;
-    };
+            while (end == 0) {
+                i = Scanner::Find(in, i, '*');
+                if ((i == std::string_view::npos) || (i + 1 >= in.length()))
+                    return 0;
 
-    class IdentifierToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::Identifier;
-        }
+                if (in[i + 1] == '/')
+                    end = i + 2;
 
-        void Process(std::string& in) override {
-            size_t i = 0;
-            std::string id = "";
-
-            for (; i < in.length(); i++) {
-                if ((in[i] >= 'a') && (in[i] <= 'z'))
-                    id += in[i];
-                
-                else if ((in[i] >= 'A') && (in[i] <= 'Z'))
-                    id += in[i];
-                
-                else if ((in[i] >= '0') && (in[i] <= '9'))
-                    id += in[i];
-                
-                else if (in[i] == '_')
-                    id += in[i];
-                
-                else
-                    break;
+                i++;
             }
 
-            uint8_t* str = new uint8_t[i + 1];
-            memcpy(str, in.c_str(), i);
-            str[i] = '\0';
-            in.erase(0, i);
-
-            value = std::shared_ptr<uint8_t[]>(str);
+            record.kind = (uint32_t)TokenType::Type::Ignore;
+            return end;
         }
-
-        std::shared_ptr<void> GetData() override {
-            return value;
-        }
-
-        std::string GetName() const override {
-            const char* str = (const char*)value.get();
-            return std::string("Identifier ") + str;
-        }
-
-    private:
-        std::shared_ptr<uint8_t[]> value;
     };
 
     class FloatingSinglePattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             bool period = false;
             bool before = false;
             bool after = false;
@@ -614,14 +195,23 @@ namespace Martin {
             return period && before && after && found_f;
         }
 
-        Token CreateToken() const override {
-            return Token(new FloatingSingleToken);
+        bool CanStartWith(char c) const override {
+            return (c == '-') || ((c >= '0') && (c <= '9'));
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t index = in.find('f');
+
+            record.kind = (uint32_t)TokenType::Type::FloatingSingle;
+            record.payload = buffer.AddLiteral();
+
+            return index + 1;
         }
     };
 
     class FloatingDoublePattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             bool period = false;
             bool before = false;
             bool after = false;
@@ -646,72 +236,25 @@ namespace Martin {
             return period && before && after;
         }
 
-        Token CreateToken() const override {
-            return Token(new FloatingDoubleToken);
+        bool CanStartWith(char c) const override {
+            return (c == '-') || ((c >= '0') && (c <= '9'));
         }
-    };
 
-    class NewLinePattern : public PatternType {
-    public:
-        bool IsMatch(const std::string& in) const override {
-            return in[0] == '\n';
-        }
-
-        Token CreateToken() const override {
-            return Token(new NewLineToken);
-        }
-    };
-
-    class WhiteSpacePattern : public PatternType {
-    public:
-        bool IsMatch(const std::string& in) const override {
-            return (in[0] == ' ') || (in[0] == '\t') || (in[0] == '\r');
-        }
-
-        Token CreateToken() const override {
-            return Token(new WhiteSpaceToken);
-        }
-    };
-
-    class CommentSingleLinePattern : public PatternType {
-    public:
-        bool IsMatch(const std::string& in) const override {
-            if (in.length() < 2)
-                return false;
-
-            return (in[0] == '/') && (in[1] == '/');
-        }
-
-        Token CreateToken() const override {
-            return Token(new CommentSingleLineToken);
-        }
-    };
-
-    class CommentMultiLinePattern : public PatternType {
-    public:
-        bool IsMatch(const std::string& in) const override {
-            if (in.length() < 2)
-                return false;
-            
-            if ((in[0] != '/') || (in[1] != '*'))
-                return false;
-            
-            for (size_t i = 3; i < in.length(); i++) {
-                if ((in[i-1] == '*') && (in[i] == '/'))
-                    return true;
-            }
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t index = in.find_first_not_of("-1234567890.");
+            if (index == std::string_view::npos)
+                index = in.length();
 
-            return false;
-        }
+            record.kind = (uint32_t)TokenType::Type::FloatingDouble;
+            record.payload = buffer.AddLiteral();
 
-        Token CreateToken() const override {
-            return Token(new CommentMultiLineToken);
+            return index;
         }
     };
 
     class UIntegerPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             char c = in[0];
             
             if ((c != 'u') && (c != '0'))
@@ -742,14 +285,85 @@ namespace Martin {
             return false;
         };
 
-        Token CreateToken() const {
-            return Token(new UIntegerToken);
+        bool CanStartWith(char c) const override {
+            return (c == 'u') || (c == '0');
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            NumberType type = NumberType::Decimal;
+            unsigned int radix = 10;
+            size_t i = 1;
+            
+            if (in.length() > i) {
+                switch (in[i]) {
+                    case 'x':
+                    case 'X':
+                        type = NumberType::Hexidecimal;
+                        radix = 16;
+                        i++;
+                        break;
+                    case 'o':
+                    case 'O':
+                        type = NumberType::Octal;
+                        radix = 8;
+                        i++;
+                        break;
+                    case 'b':
+                    case 'B':
+                        type = NumberType::Binary;
+                        radix = 2;
+                        i++;
+                        break;
+                }
+            }
+
+            size_t start = i;
+            size_t significant = 0;
+
+            for (; i < in.length(); i++) {
+                char c = in[i];
+
+                if ((c != '_') && !IsDigit(type, c))
+                    break;
+
+                if ((c != '_') && (significant || (c != '0')))
+                    significant++;
+            }
+
+            // The value itself is decoded when something reads it
+            if (significant > Numbers::GetSafeDigits(radix)) {
+                uintmax_t value;
+                if (Numbers::ParseUnsigned(in.substr(start, i - start), radix, value) == Numbers::Result::Overflow)
+                    state.SetProblem(LexerState::Problem::Overflow);
+            }
+
+            record.kind = (uint32_t)TokenType::Type::UInteger;
+            record.payload = buffer.AddLiteral();
+
+            return i;
+        }
+
+    private:
+        static bool IsDigit(NumberType type, char c) {
+            switch (type) {
+                case NumberType::Hexidecimal:
+                    return ((c >= '0') && (c <= '9')) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F'));
+                
+                case NumberType::Octal:
+                    return (c >= '0') && (c <= '7');
+                
+                case NumberType::Binary:
+                    return (c == '0') || (c == '1');
+                
+                default:
+                    return (c >= '0') && (c <= '9');
+            }
         }
     };
 
     class IntegerPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             char c = in[0];
             size_t index = 0;
 
@@ -768,62 +382,111 @@ namespace Martin {
             return false;
         };
 
-        Token CreateToken() const {
-            return Token(new IntegerToken);
+        bool CanStartWith(char c) const override {
+            return (c == '-') || ((c >= '0') && (c <= '9'));
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t i = (in[0] == '-') ? 1 : 0;
+            size_t significant = 0;
+
+            for (; i < in.length(); i++) {
+                char c = in[i];
+
+                if ((c != '_') && ((c < '0') || (c > '9')))
+                    break;
+
+                if ((c != '_') && (significant || (c != '0')))
+                    significant++;
+            }
+
+            // The value itself is decoded when something reads it
+            if (significant > Numbers::GetSafeDigits(10, true)) {
+                intmax_t value;
+                if (Numbers::ParseSigned(in.substr(0, i), value) == Numbers::Result::Overflow)
+                    state.SetProblem(LexerState::Problem::Overflow);
+            }
+
+            record.kind = (uint32_t)TokenType::Type::Integer;
+            record.payload = buffer.AddLiteral();
+
+            return i;
         }
     };
 
     class BooleanPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
-            if (StrHelper::IsFirstMatch(in.c_str(), "true"))
+        bool IsMatch(std::string_view in) const override {
+            if (StrHelper::IsFirstMatch(in, "true"))
                 return true;
             
-            else if (StrHelper::IsFirstMatch(in.c_str(), "false"))
+            else if (StrHelper::IsFirstMatch(in, "false"))
                 return true;
             
             return false;
         }
 
-        Token CreateToken() const override {
-            return Token(new BooleanToken);
+        bool CanStartWith(char c) const override {
+            return (c == 't') || (c == 'f');
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            record.kind = (uint32_t)TokenType::Type::Boolean;
+
+            if (in[0] == 't') {
+                record.payload = 1;
+                return std::strlen("true");
+            } else {
+                record.payload = 0;
+                return std::strlen("false");
+            }
         }
     };
 
     class String8Pattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if ((in[0] == '8') && (in.size() >= 2))
                 return StrHelper::IsMatch(in.substr(1));
 
             return StrHelper::IsMatch(in);
         }
 
-        Token CreateToken() const override {
-            return Token(new String8Token);
+        bool CanStartWith(char c) const override {
+            return (c == '8') || (c == '\'') || (c == '\"') || (c == '`');
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t prefix = (in[0] == '8') ? 1 : 0;
+
+            return StrHelper::Process(state, in, prefix, record, buffer, TokenType::Type::String8);
         }
     };
 
     class String16Pattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if (in.size() < 2)
                 return false;
 
-            else if ((in[0] != '1') || (in[1] == '6'))
+            else if ((in[0] != '1') || (in[1] != '6'))
                 return false;
 
             return StrHelper::IsMatch(in.substr(2));
         }
 
-        Token CreateToken() const override {
-            return Token(new String16Token);
+        bool CanStartWith(char c) const override {
+            return c == '1';
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            return StrHelper::Process(state, in, 2, record, buffer, TokenType::Type::String16);
         }
     };
 
     class String32Pattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if (in.size() < 2)
                 return false;
 
@@ -833,14 +496,18 @@ namespace Martin {
             return StrHelper::IsMatch(in.substr(2));
         }
 
-        Token CreateToken() const override {
-            return Token(new String32Token);
+        bool CanStartWith(char c) const override {
+            return c == '3';
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            return StrHelper::Process(state, in, 2, record, buffer, TokenType::Type::String32);
         }
     };
 
     class String16lPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if (in.size() < 3)
                 return false;
 
@@ -850,14 +517,18 @@ namespace Martin {
             return StrHelper::IsMatch(in.substr(3));
         }
 
-        Token CreateToken() const override {
-            return Token(new String16lToken);
+        bool CanStartWith(char c) const override {
+            return c == '1';
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            return StrHelper::Process(state, in, 3, record, buffer, TokenType::Type::String16l);
         }
     };
 
     class String32lPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if (in.size() < 3)
                 return false;
 
@@ -867,14 +538,18 @@ namespace Martin {
             return StrHelper::IsMatch(in.substr(3));
         }
 
-        Token CreateToken() const override {
-            return Token(new String32lToken);
+        bool CanStartWith(char c) const override {
+            return c == '3';
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            return StrHelper::Process(state, in, 3, record, buffer, TokenType::Type::String32l);
         }
     };
 
     class String16bPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if (in.size() < 3)
                 return false;
 
@@ -884,14 +559,18 @@ namespace Martin {
             return StrHelper::IsMatch(in.substr(3));
         }
 
-        Token CreateToken() const override {
-            return Token(new String16bToken);
+        bool CanStartWith(char c) const override {
+            return c == '1';
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            return StrHelper::Process(state, in, 3, record, buffer, TokenType::Type::String16b);
         }
     };
 
     class String32bPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             if (in.size() < 3)
                 return false;
 
@@ -901,14 +580,18 @@ namespace Martin {
             return StrHelper::IsMatch(in.substr(3));
         }
 
-        Token CreateToken() const override {
-            return Token(new String32bToken);
+        bool CanStartWith(char c) const override {
+            return c == '3';
+        }
+
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            return StrHelper::Process(state, in, 3, record, buffer, TokenType::Type::String32b);
         }
     };
 
     class IdentifierPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
+        bool IsMatch(std::string_view in) const override {
             size_t i = 0;
             char c = in[i];
             while (c == '_') {
@@ -931,127 +614,57 @@ namespace Martin {
             return false;
         }
 
-        Token CreateToken() const override {
-            return Token(new IdentifierToken);
+        bool CanStartWith(char c) const override {
+            return (c == '_') || ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
         }
-    };
 
-    FixedToken(KWFromToken, KWFromPattern, Type::KW_From, "from")
-    FixedToken(KWImportToken, KWImportPattern, Type::KW_Import, "import")
-    FixedToken(KWAsToken, KWAsPattern, Type::KW_As, "as")
-    FixedToken(KWInToken, KWInPattern, Type::KW_In, "in")
-    FixedToken(KWStructToken, KWStructPattern, Type::KW_Struct, "struct")
-    FixedToken(KWUnionToken, KWUnionPattern, Type::KW_Union, "union")
-    FixedToken(KWEnumToken, KWEnumPattern, Type::KW_Enum, "enum")
-    FixedToken(KWTypedefToken, KWTypedefPattern, Type::KW_Typedef, "typedef")
-    FixedToken(KWLetToken, KWLetPattern, Type::KW_Let, "let")
-    FixedToken(KWSetToken, KWSetPattern, Type::KW_Set, "set")
-    FixedToken(KWConstToken, KWConstPattern, Type::KW_Const, "const")
-    FixedToken(KWConstexprToken, KWConstexprPattern, Type::KW_Constexpr, "constexpr")
-
-    class KWArrayToken : public TokenType {
-    public:
-        Type GetType() const override {
-            return Type::KW_Array;
-        }
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            size_t i = 0;
 
-        void Process(std::string& in) override {
-            in.erase(0, std::strlen("array"));
-        }
+            for (; i < in.length(); i++) {
+                if ((in[i] >= 'a') && (in[i] <= 'z'))
+                    continue;
+                
+                else if ((in[i] >= 'A') && (in[i] <= 'Z'))
+                    continue;
+                
+                else if ((in[i] >= '0') && (in[i] <= '9'))
+                    continue;
+                
+                else if (in[i] == '_')
+                    continue;
+                
+                else
+                    break;
+            }
+
+            record.kind = (uint32_t)TokenType::Type::Identifier;
+            record.payload = InternerSingleton.Intern(in.substr(0, i));
 
-        std::string GetName() const override {
-            return "array ";
+            return i;
         }
     };
 
+    MARTIN_FIXED_TOKENS(FixedToken, FixedTokenSYM)
+
     class KWArrayPattern : public PatternType {
     public:
-        bool IsMatch(const std::string& in) const override {
-            return StrHelper::IsFirstMatch(in.c_str(), "array[");
+        bool IsMatch(std::string_view in) const override {
+            return StrHelper::IsFirstMatch(in, "array[");
         }
-        Token CreateToken() const override {
-            return Token(new KWArrayToken);
+        bool CanStartWith(char c) const override {
+            return c == 'a';
+        }
+        const char* GetFixed() const override {
+            return "array[";
+        }
+        size_t Process(std::string_view in, LexerState& state, TokenRecord& record, TokenBufferBase& buffer) const override {
+            record.kind = (uint32_t)TokenType::Type::KW_Array;
+            return std::strlen("array");
         }
     };
 
-    FixedToken(KWReferenceToken, KWReferencePattern, Type::KW_Reference, "reference")
-    FixedToken(KWSharedToken, KWSharedPattern, Type::KW_Shared, "shared")
-    FixedToken(KWUniqueToken, KWUniquePattern, Type::KW_Unique, "unique")
-    FixedToken(KWPointerToken, KWPointerPattern, Type::KW_Pointer, "pointer")
-    FixedToken(KWExternToken, KWExternPattern, Type::KW_Extern, "extern")
-    FixedToken(KWUnsafeToken, KWUnsafePattern, Type::KW_Unsafe, "unsafe")
-    FixedToken(KWFuncToken, KWFuncPattern, Type::KW_Func, "func")
-    FixedToken(KWClassToken, KWClassPattern, Type::KW_Class, "class")
-    FixedToken(KWPublicToken, KWPublicPattern, Type::KW_Public, "public")
-    FixedToken(KWProtectedToken, KWProtectedPattern, Type::KW_Protected, "protected")
-    FixedToken(KWPrivateToken, KWPrivatePattern, Type::KW_Private, "private")
-    FixedToken(KWFriendToken, KWFriendPattern, Type::KW_Friend, "friend");
-    FixedToken(KWVirtualToken, KWVirtualPattern, Type::KW_Virtual, "virtual")
-    FixedToken(KWOverrideToken, KWOverridePattern, Type::KW_Override, "override")
-    FixedToken(KWStaticToken, KWStaticPattern, Type::KW_Static, "static")
-    FixedToken(KWGetterToken, KWGetterPattern, Type::KW_Getter, "getter")
-    FixedToken(KWSetterToken, KWSetterPattern, Type::KW_Setter, "setter")
-    FixedToken(KWIfToken, KWIfPattern, Type::KW_If, "if")
-    FixedToken(KWElifToken, KWElifPattern, Type::KW_Elif, "elif")
-    FixedToken(KWElseToken, KWElsePattern, Type::KW_Else, "else")
-    FixedToken(KWForToken, KWForPattern, Type::KW_For, "for")
-    FixedToken(KWForeachToken, KWForeachPattern, Type::KW_Foreach, "foreach")
-    FixedToken(KWWhileToken, KWWhilePattern, Type::KW_While, "while")
-    FixedToken(KWContinueToken, KWContinuePattern, Type::KW_Continue, "continue")
-    FixedToken(KWBreakToken, KWBreakPattern, Type::KW_Break, "break")
-    FixedToken(KWMatchToken, KWMatchPattern, Type::KW_Match, "match")
-    FixedToken(KWSwitchToken, KWSwitchPattern, Type::KW_Switch, "switch")
-    FixedToken(KWReturnToken, KWReturnPattern, Type::KW_Return, "return")
-    FixedToken(KWLambdaToken, KWLambdaPattern, Type::KW_Lambda, "lambda")
-    FixedToken(KWAndToken, KWAndPattern, Type::KW_And, "and")
-    FixedToken(KWOrToken, KWOrPattern, Type::KW_Or, "or")
-    FixedToken(KWNotToken, KWNotPattern, Type::KW_Not, "not")
-
-    FixedTokenSYM(SYMCommaToken, SYMCommaPattern, Type::SYM_Comma, ",")
-    FixedTokenSYM(SYMPeriodToken, SYMPeriodPattern, Type::SYM_Period, ".")
-    FixedTokenSYM(SYMOpenCurlyToken, SYMOpenCurlyPattern, Type::SYM_OpenCurly, "{")
-    FixedTokenSYM(SYMCloseCurlyToken, SYMCloseCurlyPattern, Type::SYM_CloseCurly, "}")
-    FixedTokenSYM(SYMOpenBracketToken, SYMOpenBracketPattern, Type::SYM_OpenBracket, "[")
-    FixedTokenSYM(SYMCloseBracketToken, SYMCloseBracketPattern, Type::SYM_CloseBracket, "]")
-    FixedTokenSYM(SYMOpenParenthesesToken, SYMOpenParenthesesPattern, Type::SYM_OpenParentheses, "(")
-    FixedTokenSYM(SYMCloseParenthesesToken, SYMCloseParenthesesPattern, Type::SYM_CloseParentheses, ")")
-    FixedTokenSYM(SYMSemiColonToken, SYMSemiColonPattern, Type::SYM_SemiColon, ";")
-    FixedTokenSYM(SYMColonToken, SYMColonPattern, Type::SYM_Colon, ":")
-    FixedTokenSYM(SYMArrowToken, SYMArrowPattern, Type::SYM_Arrow, "->")
-    FixedTokenSYM(SYMAddToken, SYMAddPattern, Type::SYM_Add, "+")
-    FixedTokenSYM(SYMSubToken, SYMSubPattern, Type::SYM_Sub, "-")
-    FixedTokenSYM(SYMMulToken, SYMMulPattern, Type::SYM_Mul, "*")
-    FixedTokenSYM(SYMDivToken, SYMDivPattern, Type::SYM_Div, "/")
-    FixedTokenSYM(SYMModToken, SYMModPattern, Type::SYM_Mod, "%")
-    FixedTokenSYM(SYMPowToken, SYMPowPattern, Type::SYM_Pow, "**")
-    FixedTokenSYM(SYMBitAndToken, SYMBitAndPattern, Type::SYM_BitAnd, "&")
-    FixedTokenSYM(SYMBitOrToken, SYMBitOrPattern, Type::SYM_BitOr, "|")
-    FixedTokenSYM(SYMBitXOrToken, SYMBitXOrPattern, Type::SYM_BitXOr, "^")
-    FixedTokenSYM(SYMBitNotToken, SYMBitNotPattern, Type::SYM_BitNot, "~")
-    FixedTokenSYM(SYMBitShiftLeftToken, SYMBitShiftLeftPattern, Type::SYM_BitShiftLeft, "<<")
-    FixedTokenSYM(SYMBitShiftRightToken, SYMBitShiftRightPattern, Type::SYM_BitShiftRight, ">>")
-    FixedTokenSYM(SYMAssignToken, SYMAssignPattern, Type::SYM_Assign, "=")
-    FixedTokenSYM(SYMTypeAssignToken, SYMTypeAssignPattern, Type::SYM_TypeAssign, ":=")
-    FixedTokenSYM(SYMAssignAddToken, SYMAssignAddPattern, Type::SYM_AssignAdd, "+=")
-    FixedTokenSYM(SYMAssignSubToken, SYMAssignSubPattern, Type::SYM_AssignSub, "-=")
-    FixedTokenSYM(SYMAssignMulToken, SYMAssignMulPattern, Type::SYM_AssignMul, "*=")
-    FixedTokenSYM(SYMAssignDivToken, SYMAssignDivPattern, Type::SYM_AssignDiv, "/=")
-    FixedTokenSYM(SYMAssignModToken, SYMAssignModPattern, Type::SYM_AssignMod, "%=")
-    FixedTokenSYM(SYMAssignPowToken, SYMAssignPowPattern, Type::SYM_AssignPow, "**=")
-    FixedTokenSYM(SYMAssignBitAndToken, SYMAssignBitAndPattern, Type::SYM_AssignBitAnd, "&=")
-    FixedTokenSYM(SYMAssignBitOrToken, SYMAssignBitOrPattern, Type::SYM_AssignBitOr, "|=")
-    FixedTokenSYM(SYMAssignBitXOrToken, SYMAssignBitXOrPattern, Type::SYM_AssignBitXOr, "^=")
-    FixedTokenSYM(SYMAssignBitNotToken, SYMAssignBitNotPattern, Type::SYM_AssignBitNot, "~=")
-    FixedTokenSYM(SYMAssignBitShiftLeftToken, SYMAssignBitShiftLeftPattern, Type::SYM_AssignBitShiftLeft, "<<=")
-    FixedTokenSYM(SYMAssignBitShiftRightToken, SYMAssignBitShiftRightPattern, Type::SYM_AssignBitShiftRight, ">>=")
-    FixedTokenSYM(SYMEqualsToken, SYMEqualsPattern, Type::SYM_Equals, "==")
-    FixedTokenSYM(SYMNotEqualsToken, SYMNotEqualsPattern, Type::SYM_NotEquals, "!=")
-    FixedTokenSYM(SYMLessThanToken, SYMLessThanPattern, Type::SYM_LessThan, "<")
-    FixedTokenSYM(SYMGreaterThanToken, SYMGreaterThanPattern, Type::SYM_GreaterThan, ">")
-    FixedTokenSYM(SYMLessThanEqualsToken, SYMLessThanEqualsPattern, Type::SYM_LessThanEquals, "<=")
-    FixedTokenSYM(SYMGreaterThanEqualsToken, SYMGreaterThanEqualsPattern, Type::SYM_GreaterThanEquals, ">=")
-
-    Tokenizer::Tokenizer() {
+    Tokenizer::Tokenizer(Matching matching) : matching(matching) {
         patterns.push_back(Pattern(new NewLinePattern));
         patterns.push_back(Pattern(new WhiteSpacePattern));
         patterns.push_back(Pattern(new CommentSingleLinePattern));
@@ -1068,134 +681,365 @@ namespace Martin {
         patterns.push_back(Pattern(new UIntegerPattern));
         patterns.push_back(Pattern(new IntegerPattern));
         patterns.push_back(Pattern(new BooleanPattern));
-        patterns.push_back(Pattern(new KWFromPattern));
-        patterns.push_back(Pattern(new KWImportPattern));
-        patterns.push_back(Pattern(new KWAsPattern));
-        patterns.push_back(Pattern(new KWInPattern));
-        patterns.push_back(Pattern(new KWStructPattern));
-        patterns.push_back(Pattern(new KWUnionPattern));
-        patterns.push_back(Pattern(new KWEnumPattern));
-        patterns.push_back(Pattern(new KWTypedefPattern));
-        patterns.push_back(Pattern(new KWLetPattern));
-        patterns.push_back(Pattern(new KWSetPattern));
-        patterns.push_back(Pattern(new KWConstPattern));
-        patterns.push_back(Pattern(new KWConstexprPattern));
         patterns.push_back(Pattern(new KWArrayPattern));
-        patterns.push_back(Pattern(new KWReferencePattern));
-        patterns.push_back(Pattern(new KWSharedPattern));
-        patterns.push_back(Pattern(new KWUniquePattern));
-        patterns.push_back(Pattern(new KWPointerPattern));
-        patterns.push_back(Pattern(new KWExternPattern));
-        patterns.push_back(Pattern(new KWUnsafePattern));
-        patterns.push_back(Pattern(new KWFuncPattern));
-        patterns.push_back(Pattern(new KWClassPattern));
-        patterns.push_back(Pattern(new KWPublicPattern));
-        patterns.push_back(Pattern(new KWProtectedPattern));
-        patterns.push_back(Pattern(new KWPrivatePattern));
-        patterns.push_back(Pattern(new KWFriendPattern));
-        patterns.push_back(Pattern(new KWVirtualPattern));
-        patterns.push_back(Pattern(new KWOverridePattern));
-        patterns.push_back(Pattern(new KWStaticPattern));
-        patterns.push_back(Pattern(new KWGetterPattern));
-        patterns.push_back(Pattern(new KWSetterPattern));
-        patterns.push_back(Pattern(new KWIfPattern));
-        patterns.push_back(Pattern(new KWElifPattern));
-        patterns.push_back(Pattern(new KWElsePattern));
-        patterns.push_back(Pattern(new KWForeachPattern));
-        patterns.push_back(Pattern(new KWForPattern));
-        patterns.push_back(Pattern(new KWWhilePattern));
-        patterns.push_back(Pattern(new KWContinuePattern));
-        patterns.push_back(Pattern(new KWBreakPattern));
-        patterns.push_back(Pattern(new KWMatchPattern));
-        patterns.push_back(Pattern(new KWSwitchPattern));
-        patterns.push_back(Pattern(new KWReturnPattern));
-        patterns.push_back(Pattern(new KWLambdaPattern));
-        patterns.push_back(Pattern(new KWAndPattern));
-        patterns.push_back(Pattern(new KWOrPattern));
-        patterns.push_back(Pattern(new KWNotPattern));
-        patterns.push_back(Pattern(new SYMCommaPattern));
-        patterns.push_back(Pattern(new SYMPeriodPattern));
-        patterns.push_back(Pattern(new SYMOpenCurlyPattern));
-        patterns.push_back(Pattern(new SYMCloseCurlyPattern));
-        patterns.push_back(Pattern(new SYMOpenBracketPattern));
-        patterns.push_back(Pattern(new SYMCloseBracketPattern));
-        patterns.push_back(Pattern(new SYMOpenParenthesesPattern));
-        patterns.push_back(Pattern(new SYMCloseParenthesesPattern));
-        patterns.push_back(Pattern(new SYMSemiColonPattern));
-        patterns.push_back(Pattern(new SYMTypeAssignPattern));
-        patterns.push_back(Pattern(new SYMColonPattern));
-        patterns.push_back(Pattern(new SYMArrowPattern));
-        patterns.push_back(Pattern(new SYMAssignAddPattern));
-        patterns.push_back(Pattern(new SYMAssignSubPattern));
-        patterns.push_back(Pattern(new SYMAssignMulPattern));
-        patterns.push_back(Pattern(new SYMAssignDivPattern));
-        patterns.push_back(Pattern(new SYMAssignModPattern));
-        patterns.push_back(Pattern(new SYMAssignPowPattern));
-        patterns.push_back(Pattern(new SYMAssignBitAndPattern));
-        patterns.push_back(Pattern(new SYMAssignBitOrPattern));
-        patterns.push_back(Pattern(new SYMAssignBitXOrPattern));
-        patterns.push_back(Pattern(new SYMAssignBitNotPattern));
-        patterns.push_back(Pattern(new SYMAssignBitShiftLeftPattern));
-        patterns.push_back(Pattern(new SYMAssignBitShiftRightPattern));
-        patterns.push_back(Pattern(new SYMAddPattern));
-        patterns.push_back(Pattern(new SYMSubPattern));
-        patterns.push_back(Pattern(new SYMPowPattern));
-        patterns.push_back(Pattern(new SYMMulPattern));
-        patterns.push_back(Pattern(new SYMDivPattern));
-        patterns.push_back(Pattern(new SYMModPattern));
-        patterns.push_back(Pattern(new SYMBitAndPattern));
-        patterns.push_back(Pattern(new SYMBitOrPattern));
-        patterns.push_back(Pattern(new SYMBitXOrPattern));
-        patterns.push_back(Pattern(new SYMBitNotPattern));
-        patterns.push_back(Pattern(new SYMBitShiftLeftPattern));
-        patterns.push_back(Pattern(new SYMBitShiftRightPattern));
-        patterns.push_back(Pattern(new SYMEqualsPattern));
-        patterns.push_back(Pattern(new SYMNotEqualsPattern));
-        patterns.push_back(Pattern(new SYMLessThanEqualsPattern));
-        patterns.push_back(Pattern(new SYMGreaterThanEqualsPattern));
-        patterns.push_back(Pattern(new SYMLessThanPattern));
-        patterns.push_back(Pattern(new SYMGreaterThanPattern));
-        patterns.push_back(Pattern(new SYMAssignPattern));
+        MARTIN_FIXED_TOKENS(RegisterFixedToken, RegisterFixedToken)
         patterns.push_back(Pattern(new IdentifierPattern));
+
+        BuildDispatchTable();
     }
 
-    TokenList Tokenizer::TokenizeString(std::string input) {
-        std::vector<Token> tokens;
-        size_t str_length;
+    void Tokenizer::BuildDispatchTable() {
+        // Every byte used by a fixed spelling gets its own class, the rest share the dead class 0
+        for (auto pattern : patterns) {
+            const char* fixed = pattern->GetFixed();
+            if (!fixed)
+                continue;
+
+            for (size_t i = 0; fixed[i] != '\0'; i++) {
+                uint8_t c = (uint8_t)fixed[i];
+                if (byte_classes[c] == 0)
+                    byte_classes[c] = (uint8_t)class_count++;
+            }
+        }
+
+        // Dead and start states
+        transitions.assign(class_count * 2, 0);
+        accepts.assign(2, nullptr);
+
+        for (auto pattern : patterns) {
+            const char* fixed = pattern->GetFixed();
+            if (!fixed)
+                continue;
+
+            size_t state = 1;
+            size_t i = 0;
+            for (; fixed[i] != '\0'; i++) {
+                size_t index = state * class_count + byte_classes[(uint8_t)fixed[i]];
+
+                if (transitions[index] == 0) {
+                    transitions[index] = (uint16_t)accepts.size();
+                    transitions.resize(transitions.size() + class_count, 0);
+                    accepts.push_back(nullptr);
+                }
+
+                state = transitions[index];
+            }
+
+            if (!accepts[state])
+                accepts[state] = pattern;
+
+            longest_fixed = std::max(longest_fixed, i);
+        }
+
+        if (longest_fixed > max_fixed_length)
+            Fatal("Fixed token spellings are limited to $ characters\n", max_fixed_length);
 
-        while (input.length() != 0) {
-            str_length = input.length();
+        // Fixed patterns are registered as one contiguous block, so consulting
+        // the DFA where the first of them would have been tried keeps the
+        // registration order for everything else
+        for (size_t c = 0; c < 256; c++) {
+            bool has_fixed = false;
 
             for (auto pattern : patterns) {
-                if (pattern->IsMatch(input)) {
-                    Token t = pattern->CreateToken();
-                    if (t != nullptr) {
-                        t->SetLineNumber(line_number);
-                        t->Process(input);
-
-                        if (t->GetType() != TokenType::Type::Ignore) 
-                            tokens.push_back(t);
-                        
+                if (!pattern->CanStartWith((char)c))
+                    continue;
+
+                if (pattern->GetFixed()) {
+                    if (!has_fixed)
+                        dispatch[c].push_back(nullptr);
+                    
+                    has_fixed = true;
+                } else
+                    dispatch[c].push_back(pattern);
+            }
+        }
+    }
+
+    const PatternType* Tokenizer::FindPattern(std::string_view in) const {
+        if (matching == Matching::PatternChain) {
+            for (auto& pattern : patterns) {
+                if (pattern->IsMatch(in))
+                    return pattern.get();
+            }
+
+            return nullptr;
+        }
+
+        for (auto& pattern : dispatch[(uint8_t)in[0]]) {
+            if (!pattern) {
+                const PatternType* fixed = FindFixedPattern(in);
+                if (fixed)
+                    return fixed;
+            
+            } else if (pattern->IsMatch(in))
+                return pattern.get();
+        }
+
+        return nullptr;
+    }
+
+    const PatternType* Tokenizer::FindFixedPattern(std::string_view in) const {
+        // Accepting states seen along the walk, the longest one that still
+        // passes its pattern's boundary check wins
+        size_t seen[max_fixed_length];
+        size_t seen_count = 0;
+        size_t state = 1;
+
+        for (size_t i = 0; (i < in.length()) && (i < longest_fixed); i++) {
+            state = transitions[state * class_count + byte_classes[(uint8_t)in[i]]];
+            if (state == 0)
+                break;
+
+            if (accepts[state])
+                seen[seen_count++] = state;
+        }
+
+        while (seen_count != 0) {
+            const Pattern& pattern = accepts[seen[--seen_count]];
+            if (pattern->IsMatch(in))
+                return pattern.get();
+        }
+
+        return nullptr;
+    }
+
+    TokenBuffer Tokenizer::TokenizeBuffer(std::string_view input) {
+        return TokenizeBuffer(SourceBufferBase::FromString(input));
+    }
+
+    TokenBuffer Tokenizer::TokenizeBuffer(SourceBuffer input) {
+        TokenBuffer buffer = TokenBuffer(new TokenBufferBase(input));
+        LexerState state;
+
+        buffer->Reserve(input->GetSize() / 4);
+        Lex(*buffer, state, input->GetSize());
+
+        return buffer;
+    }
+
+    void Tokenizer::Lex(TokenBufferBase& buffer, LexerState& state, size_t end) const {
+        while (state.GetPosition() < end)
+            Step(buffer, state);
+    }
+
+    void Tokenizer::Step(TokenBufferBase& buffer, LexerState& state) const {
+        std::string_view rest = buffer.GetSource().substr(state.GetPosition());
+        size_t length = 0;
+
+        TokenRecord record;
+        record.payload = 0;
+
+        const PatternType* pattern = FindPattern(rest);
+        if (pattern) {
+            length = pattern->Process(rest, state, record, buffer);
+            record.offset = (uint32_t)state.GetPosition();
+            record.length = (uint32_t)length;
+
+            if (record.kind != (uint32_t)TokenType::Type::Ignore) 
+                buffer.Push(record);
+        }
+
+        if ((length == 0) || (state.GetProblem() != LexerState::Problem::None)) {
+            // TODO error
+            std::string text(rest.substr(0, (length == 0) ? rest.find('\n') : length));
+            text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+
+            SourceBuffer source = buffer.GetSourceBuffer();
+            unsigned int line = source->GetLine(state.GetPosition());
+            unsigned int column = source->GetColumn(state.GetPosition());
+
+            if (state.GetProblem() == LexerState::Problem::Overflow) {
+                const char* range = (record.kind == (uint32_t)TokenType::Type::Integer) ? "Int64" : "UIntMax";
+                Fatal("Number literal \"$\" on line $, column $ doesn't fit in $\n", text, line, column, range);
+            }
+
+            // A pattern only matches and consumes nothing when its literal or comment is never closed
+            if (pattern)
+                Fatal("Unterminated \"$\" on line $, column $\n", text, line, column);
+            
+            Fatal("No matching token type for \"$\" on line $, column $\n", text, line, column);
+        }
+
+        state.Advance(length);
+    }
+
+    // Offsets just past newlines that sit outside comments and strings, at
+    // most one at or after each multiple of chunk. Mirrors how the patterns
+    // treat comment and string openers, so every offset starts a token
+    static std::vector<size_t> FindChunkBoundaries(std::string_view source, size_t chunk) {
+        std::vector<size_t> boundaries;
+        size_t target = chunk;
+        size_t i = 0;
+
+        while (i < source.length()) {
+            char c = source[i];
+
+            if (c == '\n') {
+                if (i + 1 >= target) {
+                    if (i + 1 < source.length())
+                        boundaries.push_back(i + 1);
+
+                    target = i + 1 + chunk;
+                }
+
+                i++;
+            } else if ((c == '/') && (i + 1 < source.length()) && (source[i + 1] == '/')) {
+                i = Scanner::Find(source, i + 2, '\n');
+
+            } else if ((c == '/') && (i + 1 < source.length()) && (source[i + 1] == '*')) {
+                size_t star = i + 2;
+
+                while (true) {
+                    star = Scanner::Find(source, star, '*');
+                    if ((star == std::string_view::npos) || (star + 1 >= source.length()))
+                        return boundaries;
+
+                    if (source[star + 1] == '/')
                         break;
-                    }
+
+                    star++;
                 }
-            }
 
-            if (str_length == input.length()) {
-                // TODO error
-                size_t index = input.find("\r");
-                if (index != std::string::npos)
-                    input.erase(std::remove(input.begin(), input.end(), '\r'));
+                i = star + 2;
+            } else if ((c == '\'') || (c == '\"') || (c == '`')) {
+                size_t next = i + 1;
 
-                index = input.find("\n");
-                if (index != std::string::npos)
-                    input = input.substr(0, index);
-                
-                Fatal("No matching token type for \"$\" on line $\n", input, line_number);
+                while (true) {
+                    next = Scanner::FindEither(source, next, c, '\\');
+                    if (next == std::string_view::npos)
+                        return boundaries;
+
+                    if (source[next] == c)
+                        break;
+
+                    next += 2;
+                }
+
+                i = next + 1;
+            } else
+                i++;
+
+            // An unterminated comment or string leaves the rest to the last chunk
+            if (i == std::string_view::npos)
+                break;
+        }
+
+        return boundaries;
+    }
+
+    TokenBuffer Tokenizer::TokenizeParallel(SourceBuffer input, size_t threads) {
+        // Below this, splitting costs more than it saves
+        static const size_t min_chunk = 1 << 16;
+
+        if (threads == 0)
+            threads = GetDefaultThreadCount();
+
+        size_t size = input->GetSize();
+        if ((threads <= 1) || (size < min_chunk * 2))
+            return TokenizeBuffer(input);
+
+        // A few chunks per thread keeps them busy when chunks lex at different speeds
+        size_t chunk = std::max(min_chunk, size / (threads * 4));
+        std::string_view source = input->GetView();
+
+        std::vector<size_t> starts = FindChunkBoundaries(source, chunk);
+        starts.insert(starts.begin(), 0);
+
+        std::vector<TokenBuffer> buffers(starts.size());
+        ParallelFor(starts.size(), [&](size_t i) {
+            size_t end = (i + 1 < starts.size()) ? starts[i + 1] : size;
+            LexerState state(starts[i]);
+
+            buffers[i] = TokenBuffer(new TokenBufferBase(input));
+            buffers[i]->Reserve((end - starts[i]) / 4);
+            Lex(*buffers[i], state, end);
+        }, threads);
+
+        TokenBuffer buffer = buffers[0];
+        for (size_t i = 1; i < buffers.size(); i++) {
+            buffer->Append(*buffers[i]);
+            buffers[i].reset();
+        }
+
+        return buffer;
+    }
+
+    TokenBuffer Tokenizer::Relex(TokenBuffer previous, size_t offset, size_t removed, std::string_view inserted) {
+        if (!previous)
+            Fatal("Trying to relex a nullptr token buffer\n");
+
+        std::string_view old_source = previous->GetSource();
+        if ((offset > old_source.length()) || (removed > old_source.length() - offset))
+            Fatal("Edit removing $ bytes at $ is past the end of the source\n", removed, offset);
+
+        TokenBuffer buffer = TokenBuffer(new TokenBufferBase(SourceBufferBase::FromEdit(*previous->GetSourceBuffer(), offset, removed, inserted)));
+        std::string_view new_source = buffer->GetSource();
+        buffer->Reserve(previous->Size() + inserted.length() / 4);
+
+        // How far the lexer may read past where a token starts or ends to
+        // decide on it, tokens that can't see the edit stay the same
+        size_t lookahead = std::max(longest_fixed, (size_t)1);
+
+        // Count the tokens that start far enough ahead of the edit
+        size_t first = 0;
+        size_t last = previous->Size();
+        while (first < last) {
+            size_t middle = first + (last - first) / 2;
+
+            if (previous->GetRecord(middle).offset + lookahead <= offset)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+
+        // The last of them may run into the edit, so lexing restarts there
+        // and only the ones before it get copied
+        LexerState state;
+        if (first > 0) {
+            size_t restart = first - 1;
+
+            buffer->AppendShifted(*previous, 0, restart, 0);
+            state = LexerState(previous->GetRecord(restart).offset);
+        }
+
+        // Lexing from the end of the edit on gives the same tokens as the old
+        // buffer did, once the lexer lands on one of its token starts
+        ptrdiff_t shift = (ptrdiff_t)inserted.length() - (ptrdiff_t)removed;
+
+        size_t edit_end = offset + inserted.length();
+        size_t next = first;
+
+        while (state.GetPosition() < new_source.length()) {
+            size_t position = state.GetPosition();
+
+            if (position >= edit_end) {
+                while ((next < previous->Size()) && ((ptrdiff_t)previous->GetRecord(next).offset + shift < (ptrdiff_t)position))
+                    next++;
+
+                if ((next < previous->Size()) && ((ptrdiff_t)previous->GetRecord(next).offset + shift == (ptrdiff_t)position) && (previous->GetRecord(next).offset >= offset + removed)) {
+                    buffer->AppendShifted(*previous, next, previous->Size(), shift);
+                    break;
+                }
             }
+
+            Step(*buffer, state);
         }
 
-        return std::make_unique<std::vector<Token>>(tokens);
+        return buffer;
+    }
+
+    TokenBuffer Tokenizer::TokenizeBlock(SourceBuffer input, LexerState& state, size_t count) {
+        TokenBuffer buffer = TokenBuffer(new TokenBufferBase(input));
+        buffer->Reserve(count);
+
+        while ((state.GetPosition() < input->GetSize()) && (buffer->Size() < count))
+            Step(*buffer, state);
+
+        return buffer;
+    }
+
+    TokenList Tokenizer::TokenizeString(std::string_view input) {
+        return CreateTokenList(TokenizeBuffer(input));
     }
 
     Tokenizer TokenizerSingleton;
@@ -0,0 +1,107 @@
+#include <tokenstream.hpp>
+
+#include <tokenbuffer.hpp>
+#include <logging.hpp>
+
+namespace Martin {
+
+    TokenStreamBase::TokenStreamBase(SourceBuffer source, size_t capacity, bool pipelined) : source(source), capacity(capacity), pipelined(pipelined) {
+        if (!source)
+            Fatal("Trying to stream tokens from a nullptr source\n");
+
+        if (capacity < 2)
+            Fatal("A token stream needs room for at least 2 tokens, got $\n", capacity);
+
+        // Half the ring is lexed at a time, the reader can look into the other half
+        block = capacity / 2;
+        ring.resize(capacity);
+
+        if (pipelined) {
+            producer = std::thread([this]() {
+                while (Fill()) {}
+            });
+        }
+    }
+
+    TokenStreamBase::~TokenStreamBase() {
+        if (producer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+
+            writable.notify_all();
+            producer.join();
+        }
+    }
+
+    bool TokenStreamBase::Fill() {
+        // Only ever called from one thread at a time, which owns the state
+        TokenBuffer buffer = TokenizerSingleton.TokenizeBlock(source, state, block);
+        TokenList tokens = (buffer->Size() > 0) ? CreateTokenList(buffer) : nullptr;
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (tokens) {
+            writable.wait(lock, [&]() { return stopping || (count + tokens->size() <= capacity); });
+            if (stopping)
+                return false;
+
+            for (auto& token : *tokens)
+                ring[(head + count++) % capacity] = std::move(token);
+        }
+
+        if (state.GetPosition() >= source->GetSize())
+            done = true;
+
+        lock.unlock();
+        readable.notify_all();
+
+        return !done;
+    }
+
+    bool TokenStreamBase::Wait(std::unique_lock<std::mutex>& lock, size_t ahead) {
+        if (ahead >= block)
+            Fatal("Trying to look $ tokens ahead in a token stream of capacity $\n", ahead, capacity);
+
+        while ((count <= ahead) && !done) {
+            if (pipelined)
+                readable.wait(lock);
+
+            else {
+                lock.unlock();
+                Fill();
+                lock.lock();
+            }
+        }
+
+        return count > ahead;
+    }
+
+    Token TokenStreamBase::Peek(size_t ahead) {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (!Wait(lock, ahead))
+            return nullptr;
+
+        return ring[(head + ahead) % capacity];
+    }
+
+    Token TokenStreamBase::Next() {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (!Wait(lock, 0))
+            return nullptr;
+
+        // Moving the token out drops the ring's hold on its block
+        Token token = std::move(ring[head]);
+        head = (head + 1) % capacity;
+        count--;
+
+        lock.unlock();
+        writable.notify_one();
+
+        return token;
+    }
+
+}
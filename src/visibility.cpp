@@ -10,12 +10,11 @@
 namespace Martin {
 
     bool HasSubMatch(const TokenNode id, const std::string& match, size_t offset=0) {
-        std::string string;
+        Symbol symbol = id->token->GetSymbol();
+        if (symbol == InvalidSymbol)
+            return false;
 
-        Token id_token = id->token;
-
-        auto id_ptr = std::static_pointer_cast<uint8_t[]>(id_token->GetData());
-        string = *(id_ptr.get());
+        std::string_view string = InternerSingleton.GetSpelling(symbol);
 
         for (size_t i = 0; i < match.size(); i++) {
             if ((i + offset) >= string.size()) {
@@ -30,10 +29,26 @@ namespace Martin {
         return true;
     }
 
-    Visibility::Visibility(Tree tree) {
-        for (auto token_node : (*tree)) {
-            if (!token_node->is_token) {
-                switch (token_node->node->GetType()) {
+    static std::vector<Visibility::VisibilityNode> FilterBySymbol(const std::vector<Visibility::VisibilityNode>& nodes, Symbol name) {
+        std::vector<Visibility::VisibilityNode> matches;
+
+        for (auto node : nodes) {
+            if (node.id->is_token && (node.id->token->GetSymbol() == name)) {
+                matches.push_back(node);
+            }
+        }
+
+        return matches;
+    }
+
+    Visibility::Visibility(Tree tree) : Visibility(FlatTree(new FlatTreeBase(tree))) {}
+
+    Visibility::Visibility(FlatTree tree) {
+        for (auto root : tree->GetRoots()) {
+            if (!tree->IsToken(root)) {
+                const TokenNode& token_node = tree->GetItem(root);
+
+                switch (tree->GetType(root)) {
                     case TreeNodeBase::Type::Misc_Func: {
                         auto node = std::static_pointer_cast<FuncTreeNode>(token_node->node);
                         auto arrow = std::static_pointer_cast<ArrowTreeNode>(node->arrow->node);
@@ -47,7 +62,7 @@ namespace Martin {
                         auto node = std::static_pointer_cast<TypedefTreeNode>(token_node->node);
                         
                         for (auto id : node->ids) {
-                            TokenNode new_token_node = TokenNode(new TokenNodeBase);
+                            TokenNode new_token_node = MakeTokenNode();
                             new_token_node->is_token = true;
                             new_token_node->token = id;
                             types.push_back({ new_token_node });
@@ -70,7 +85,7 @@ namespace Martin {
                         auto node = std::static_pointer_cast<LetTreeNode>(token_node->node);
 
                         for (auto id : node->ids) {
-                            auto new_token_node = TokenNode(new TokenNodeBase);
+                            auto new_token_node = MakeTokenNode();
                             new_token_node->is_token = true;
                             new_token_node->token = id;
 
@@ -184,4 +199,24 @@ namespace Martin {
         return imps;
     }
 
+    const std::vector<Visibility::VisibilityNode> Visibility::GetFunctions(Symbol name) const {
+        return FilterBySymbol(functions, name);
+    }
+
+    const std::vector<Visibility::VisibilityNode> Visibility::GetTypes(Symbol name) const {
+        return FilterBySymbol(types, name);
+    }
+
+    const std::vector<Visibility::VisibilityNode> Visibility::GetVariables(Symbol name) const {
+        return FilterBySymbol(variables, name);
+    }
+
+    const std::vector<Visibility::VisibilityNode> Visibility::GetClasses(Symbol name) const {
+        return FilterBySymbol(classes, name);
+    }
+
+    const std::vector<Visibility::VisibilityNode> Visibility::GetImports(Symbol name) const {
+        return FilterBySymbol(imports, name);
+    }
+
 }
\ No newline at end of file
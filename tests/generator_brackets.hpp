@@ -0,0 +1,81 @@
+#ifndef MARTIN_TEST_GENERATOR_BRACKETS
+#define MARTIN_TEST_GENERATOR_BRACKETS
+
+#include "testing.hpp"
+
+#include <generators/enclosures.hpp>
+
+namespace Martin {
+    class Test_generator_brackets : public Test {
+    public:
+        std::string GetName() const override {
+            return "Generator(Brackets)";
+        }
+
+        bool RunTest() override {
+            // The outer pair wins when brackets of different kinds cross
+            if (!Compare("( [ ) ]", "()([); ]; ")) return false;
+            if (!Compare("{ a ( b } )", "{}(Identifier a(Identifier b); ); ")) return false;
+            // Unmatched brackets stay tokens
+            if (!Compare("( ( a ) ] [ b", "(; ()(Identifier a); ]; [; Identifier b; ")) return false;
+            if (!Compare("( a ) ( b", "()(Identifier a); (; Identifier b; ")) return false;
+            if (!Compare("((a)(b))", "()(()(Identifier a)()(Identifier b)); ")) return false;
+
+            // Deep nesting used to recurse once per level
+            const size_t depth = 3000;
+            std::string code = std::string(depth, '(') + "a" + std::string(depth, ')');
+
+            std::string error_msg;
+            Tree tree = ParserSingleton.ParseString(code, error_msg);
+            if (!tree || (tree->size() != 1)) {
+                error = "Deeply nested parentheses didn't become one node";
+                return false;
+            }
+
+            TokenNode node = (*tree)[0];
+            for (size_t i = 0; i < depth; i++) {
+                if (node->is_token || (node->node->GetType() != TreeNodeBase::Type::Struct_Parentheses)) {
+                    error = Format("Level $ isn't a parentheses node", i);
+                    return false;
+                }
+
+                Tree inside = std::static_pointer_cast<StructParenthesesTreeNode>(node->node)->inside;
+                if (inside->size() != 1) {
+                    error = Format("Level $ holds $ items", i, inside->size());
+                    return false;
+                }
+
+                node = (*inside)[0];
+            }
+
+            if (!node->is_token || (node->token->GetType() != TokenType::Type::Identifier)) {
+                error = "Innermost item isn't the identifier";
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        bool Compare(const std::string& code, const std::string& expected) {
+            std::string error_msg;
+            Tree tree = ParserSingleton.ParseString(code, error_msg);
+
+            std::string serial;
+            for (auto& node : *tree) {
+                std::string item;
+                node->Serialize(item);
+                serial += item + "; ";
+            }
+
+            if (serial != expected) {
+                error = Format("\"$\" parsed to $, expected $", code, serial, expected);
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef MARTIN_TEST_GENERATOR_EXPRESSIONS
+#define MARTIN_TEST_GENERATOR_EXPRESSIONS
+
+#include "testing.hpp"
+
+#include <generators/expressions.hpp>
+
+#include <random>
+
+namespace Martin {
+    class Test_generator_expressions : public Test {
+    public:
+        std::string GetName() const override {
+            return "Generator(Expressions)";
+        }
+
+        bool RunTest() override {
+            if (!Compare("a * b + c")) return false;
+            if (!Compare("a ** b * c")) return false;
+            if (!Compare("~ a & b << c == d and not e or f")) return false;
+            if (!Compare("a & ~ b")) return false;
+            if (!Compare("* * a -")) return false;
+            if (!Compare("not not a and b not")) return false;
+            if (!Compare("a == b == c < d")) return false;
+
+            static const char* pieces[] = {
+                "a", "b", "c", "d", "*", "/", "%", "**", "+", "-", "&", "|", "^",
+                "<<", ">>", "~", "==", "!=", "<", ">", "<=", ">=", "not", "and", "or"
+            };
+
+            std::mt19937 random(15);
+
+            for (size_t i = 0; i < 2000; i++) {
+                std::string code;
+                size_t count = 1 + random() % 14;
+                for (size_t j = 0; j < count; j++) {
+                    // Mostly operands between operators, with some broken runs
+                    if ((j % 2 == 0) && (random() % 4 != 0))
+                        code += pieces[random() % 4];
+                    else
+                        code += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+                    code += " ";
+                }
+
+                if (!Compare(code)) return false;
+            }
+
+            return true;
+        }
+
+    private:
+        // The sweeps the expression generator replaces, run the way
+        // ParseBranch runs them
+        static void Sweep(Tree tree, size_t start, size_t end) {
+            TreeGenerator generators[] = {
+                TreeGenerator(new OPMulDivModTreeGenerator),
+                TreeGenerator(new OPPowTreeGenerator),
+                TreeGenerator(new OPAddSubTreeGenerator),
+                TreeGenerator(new OPBitwiseTreeGenerator),
+                TreeGenerator(new OPEqualityTreeGenerator),
+                TreeGenerator(new OPNotLogicTreeGenerator),
+                TreeGenerator(new OPLogicalsTreeGenerator)
+            };
+
+            ParseSession session(ParserSingleton);
+            for (auto gen : generators) {
+                size_t index = start;
+                while ((index < end) && (index < tree->size())) {
+                    size_t removed = gen->ProcessBranch(session, tree, index, end);
+                    if (removed)
+                        end -= removed - 1;
+                    else
+                        index++;
+                }
+            }
+        }
+
+        static Tree CreateTree(TokenList tokens) {
+            Tree tree = Tree(new TreeBase);
+
+            for (auto tk : *tokens) {
+                TokenNode token_node = TokenNode(new TokenNodeBase);
+                token_node->token = tk;
+                token_node->is_token = true;
+                tree->push_back(token_node);
+            }
+
+            return tree;
+        }
+
+        static std::string Serialize(Tree tree) {
+            std::string serial;
+
+            for (auto node : *tree) {
+                std::string item;
+                node->Serialize(item);
+                serial += item + "; ";
+            }
+
+            return serial;
+        }
+
+        bool Compare(const std::string& code) {
+            TokenList tokens = TokenizerSingleton.TokenizeString(code);
+            size_t size = tokens->size();
+
+            // Whole trees like ParseBranch passes, and ranges that leave
+            // items on both sides out
+            size_t ranges[][2] = { { 0, size }, { 0, size / 2 }, { size / 3, size } };
+
+            for (auto& range : ranges) {
+                Tree expected = CreateTree(tokens);
+                Sweep(expected, range[0], range[1]);
+
+                Tree tree = CreateTree(tokens);
+                OPExpressionsTreeGenerator generator;
+                ParseSession session(ParserSingleton);
+                size_t removed = generator.ProcessRange(session, tree, range[0], range[1]);
+
+                std::string expected_serial = Serialize(expected);
+                std::string serial = Serialize(tree);
+
+                if ((serial != expected_serial) || (size - removed != expected->size())) {
+                    error = Format("\"$\" in [$, $) parsed to $, expected $", code, range[0], range[1], serial, expected_serial);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef MARTIN_TEST_GENERATOR_TRIGGERS
+#define MARTIN_TEST_GENERATOR_TRIGGERS
+
+#include "testing.hpp"
+
+#include <generators/seperator.hpp>
+#include <generators/dot.hpp>
+#include <generators/call.hpp>
+#include <generators/as.hpp>
+#include <generators/accesstypes.hpp>
+#include <generators/arrow.hpp>
+#include <generators/funclambda.hpp>
+#include <generators/definitions.hpp>
+#include <generators/rettypes.hpp>
+#include <generators/datatypes.hpp>
+#include <generators/assignments.hpp>
+#include <generators/flowcontrols.hpp>
+#include <generators/classtype.hpp>
+#include <generators/gettersetter.hpp>
+#include <generators/classaccess.hpp>
+#include <generators/unsafe.hpp>
+#include <generators/comma.hpp>
+#include <generators/fromimport.hpp>
+#include <generators/in.hpp>
+#include <generators/colon.hpp>
+#include <generators/class.hpp>
+#include <generators/extern.hpp>
+
+#include <random>
+
+namespace Martin {
+    class Test_generator_triggers : public Test {
+    public:
+        std::string GetName() const override {
+            return "Generator(Triggers)";
+        }
+
+        bool RunTest() override {
+            TreeGenerator generators[] = {
+                TreeGenerator(new SeperatorGenerator),
+                TreeGenerator(new OPDotTreeGenerator),
+                TreeGenerator(new CallTreeGenerator),
+                TreeGenerator(new StructAsTreeGenerator),
+                TreeGenerator(new AccessTypesTreeGenerator),
+                TreeGenerator(new ArrowTreeGenerator),
+                TreeGenerator(new LambdaTreeGenerator),
+                TreeGenerator(new DefinitionsTreeGenerator),
+                TreeGenerator(new RetTypesTreeGenerator),
+                TreeGenerator(new DataTypesTreeGenerator),
+                TreeGenerator(new AssignmentsTreeGenerator),
+                TreeGenerator(new FlowControlsTreeGenerator),
+                TreeGenerator(new FuncTreeGenerator),
+                TreeGenerator(new ClassTypeTreeGenerator),
+                TreeGenerator(new GetterSetterTreeGenerator),
+                TreeGenerator(new ClassAccessTreeGenerator),
+                TreeGenerator(new UnsafeTreeGenerator),
+                TreeGenerator(new StructCommaTreeGenerator),
+                TreeGenerator(new MiscFromImportTreeGenerator),
+                TreeGenerator(new InTreeGenerator),
+                TreeGenerator(new ColonTreeGenerator),
+                TreeGenerator(new ClassTreeGenerator),
+                TreeGenerator(new ExternTreeGenerator)
+            };
+
+            static const char* pieces[] = {
+                "a", "1", "-1", "-2.5f", "-2.5", "+", "*", ",", ".", "=", "+=", "->", ":",
+                "let", "set", "const", "func", "lambda", "if", "else", "return", "while",
+                "for", "in", "import", "from", "as", "class", "public", "static", "virtual",
+                "struct", "enum", "unsafe", "extern", "getter", "setter", "array", "pointer",
+                "typedef", "break", "\"C\""
+            };
+
+            // Nodes some generators fire on
+            std::string error_msg;
+            Tree nodes = ParserSingleton.ParseString("( a ) a . b { b }", error_msg);
+            if (!nodes || (nodes->size() != 3)) {
+                error = "Couldn't build the nodes to mix in";
+                return false;
+            }
+
+            std::mt19937 random(18);
+            ParseSession session(ParserSingleton);
+
+            for (size_t i = 0; i < 300; i++) {
+                std::string code;
+                size_t count = 1 + random() % 10;
+                for (size_t j = 0; j < count; j++) {
+                    code += pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))];
+                    code += " ";
+                }
+
+                TokenList tokens = TokenizerSingleton.TokenizeString(code);
+
+                for (auto gen : generators) {
+                    TriggerSet triggers;
+                    if (!gen->GetTriggers(triggers)) {
+                        error = "Generator without triggers";
+                        return false;
+                    }
+
+                    Tree tree = CreateTree(tokens, nodes, random);
+                    std::string before = Serialize(tree);
+
+                    // Items the triggers rule out must never be reduced
+                    for (size_t index = 0; index < tree->size(); index++) {
+                        if (triggers.Matches((*tree)[index]))
+                            continue;
+
+                        size_t removed = gen->ProcessBranch(session, tree, index, tree->size());
+                        std::string after = Serialize(tree);
+
+                        if (removed || (after != before)) {
+                            error = Format("Item $ of \"$\" isn't a trigger but changed the tree to $", index, before, after);
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            ParserSingleton.ResetCounters();
+            ParserSingleton.ParseString("let a : Int32 = f(b) + c.d\nreturn a\n", error_msg);
+
+            Parser::Counters counters = ParserSingleton.GetCounters();
+            if (!counters.calls || !counters.avoided) {
+                error = Format("Expected both calls and skipped items, got $ calls and $ skipped", counters.calls, counters.avoided);
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        static Tree CreateTree(TokenList tokens, Tree nodes, std::mt19937& random) {
+            Tree tree = Tree(new TreeBase);
+
+            for (auto tk : *tokens) {
+                if (random() % 4 == 0)
+                    tree->push_back((*nodes)[random() % nodes->size()]);
+
+                TokenNode token_node = TokenNode(new TokenNodeBase);
+                token_node->token = tk;
+                token_node->is_token = true;
+                tree->push_back(token_node);
+            }
+
+            return tree;
+        }
+
+        static std::string Serialize(Tree tree) {
+            std::string serial;
+
+            for (auto node : *tree) {
+                std::string item;
+                node->Serialize(item);
+                serial += item + "; ";
+            }
+
+            return serial;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef MARTIN_TEST_LEXER_DISPATCH
+#define MARTIN_TEST_LEXER_DISPATCH
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+
+#include "helpers/validatetree.hpp"
+
+namespace Martin {
+    class Test_lexer_dispatch : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Dispatch)";
+        }
+
+        bool RunTest() override {
+            const std::string source =
+                "from import as in struct union enum typedef let set const constexpr array[1] "
+                "reference shared unique pointer extern unsafe func class public protected private "
+                "friend virtual override static getter setter if elif else for foreach while continue "
+                "break match switch return lambda and or not setting fort iffy constexprs from_a\n"
+                ", . { } [ ] ( ) ; : -> += -= *= /= %= **= &= |= ^= ~= <<= >>= + - * / % ** & | ^ ~ "
+                "<< >> := = == != <= >= < > a<<=b>>c**d\n"
+                "true false trueish 0x1F 0o17 0b101 u12 -4 12 1.5 -2.5f 8\"a\" 'b' `c` 16l\"d\" "
+                "32b\"e\" _a __b1 // comment\n/* block */ x";
+
+            Tokenizer chain(Tokenizer::Matching::PatternChain);
+            Tokenizer table(Tokenizer::Matching::DispatchTable);
+
+            auto expected = chain.TokenizeString(source);
+            auto actual = table.TokenizeString(source);
+
+            if (!ValidateTokenList(actual, error, expected->size())) return false;
+
+            for (size_t i = 0; i < expected->size(); i++) {
+                Token a = (*expected)[i];
+                Token b = (*actual)[i];
+
+                if ((a->GetType() != b->GetType()) || (a->GetName() != b->GetName()) ||
+                    (a->GetBegin() != b->GetBegin()) || (a->GetEnd() != b->GetEnd())) {
+                    error = Format("Dispatch table returned $ at $ when the pattern chain returned $", b->GetName(), i, a->GetName());
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
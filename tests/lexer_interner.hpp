@@ -0,0 +1,85 @@
+#ifndef MARTIN_TEST_LEXER_INTERNER
+#define MARTIN_TEST_LEXER_INTERNER
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <interner.hpp>
+
+#include "helpers/validatetree.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace Martin {
+    class Test_lexer_interner : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Interner)";
+        }
+
+        bool RunTest() override {
+            auto tokens = TokenizerSingleton.TokenizeString("abc def abc \"abc\" \"xyz\"");
+
+            if (!ValidateTokenList(tokens, error, 5)) return false;
+
+            Symbol abc = (*tokens)[0]->GetSymbol();
+            if ((abc == InvalidSymbol) || ((*tokens)[2]->GetSymbol() != abc) || ((*tokens)[3]->GetSymbol() != abc)) {
+                error = "Equal spellings got different symbols";
+                return false;
+            }
+
+            if (((*tokens)[1]->GetSymbol() == abc) || ((*tokens)[4]->GetSymbol() == abc)) {
+                error = "Different spellings got the same symbol";
+                return false;
+            }
+
+            if ((InternerSingleton.GetSpelling(abc) != "abc") || (InternerSingleton.Find("abc") != abc)) {
+                error = "Symbol doesn't map back to its spelling";
+                return false;
+            }
+
+            if (std::string((const char*)std::static_pointer_cast<uint8_t[]>((*tokens)[1]->GetData()).get()) != "def") {
+                error = "GetData doesn't return the interned spelling";
+                return false;
+            }
+
+            // Threads interning overlapping spellings have to agree on every symbol
+            Interner interner;
+            std::vector<std::vector<Symbol>> results(4);
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < results.size(); t++) {
+                threads.push_back(std::thread([&, t]() {
+                    for (size_t i = 0; i < 2000; i++)
+                        results[t].push_back(interner.Intern("name_" + std::to_string((i * (t + 1)) % 2000)));
+                }));
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            for (size_t t = 0; t < results.size(); t++) {
+                for (size_t i = 0; i < 2000; i++) {
+                    std::string spelling = "name_" + std::to_string((i * (t + 1)) % 2000);
+
+                    if ((interner.GetSpelling(results[t][i]) != spelling) || (interner.Find(spelling) != results[t][i])) {
+                        error = Format("Thread $ got the wrong symbol for $", t, spelling);
+                        return false;
+                    }
+                }
+            }
+
+            Interner::Stats stats = interner.GetStats();
+            if ((stats.unique != 2000) || (stats.interned != 8000)) {
+                error = Format("Interner stats report $ unique spellings out of $", stats.unique, stats.interned);
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef MARTIN_TEST_LEXER_LAZYLITERALS
+#define MARTIN_TEST_LEXER_LAZYLITERALS
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+
+namespace Martin {
+    class Test_lexer_lazyliterals : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(LazyLiterals)";
+        }
+
+        bool RunTest() override {
+            auto buffer = TokenizerSingleton.TokenizeBuffer("1_000 -42 0b1010 0o17 0xFF u12 3.25 -1.5f \"a\\tb\" 16l\"hi\"");
+
+            if (buffer->Size() != 10) {
+                error = Format("Expected 10 tokens, got $", buffer->Size());
+                return false;
+            }
+
+            if (
+                (buffer->GetValue(0).integer != 1000) ||
+                (buffer->GetValue(1).integer != -42) ||
+                (buffer->GetValue(2).uinteger != 10) ||
+                (buffer->GetValue(3).uinteger != 15) ||
+                (buffer->GetValue(4).uinteger != 255) ||
+                (buffer->GetValue(5).uinteger != 12) ||
+                (buffer->GetValue(6).floating != 3.25) ||
+                (buffer->GetValue(7).single != -1.5f)
+            ) {
+                error = "A number literal decoded to the wrong value";
+                return false;
+            }
+
+            // Decoded once, later calls get the cached value
+            if (&buffer->GetValue(6) != &buffer->GetValue(6)) {
+                error = "Number literal wasn't cached";
+                return false;
+            }
+
+            if (std::string((const char*)buffer->GetBytes(8)) != "a\tb") {
+                error = "String literal escapes decoded wrong";
+                return false;
+            }
+
+            const uint8_t* wide = buffer->GetBytes(9);
+            if ((wide[0] != 'h') || (wide[1] != 0) || (wide[2] != 'i') || (wide[3] != 0) || (wide[4] != 0) || (wide[5] != 0)) {
+                error = "Wide string literal decoded wrong";
+                return false;
+            }
+
+            if (buffer->GetBytes(9) != wide) {
+                error = "String literal wasn't cached";
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MARTIN_TEST_LEXER_LITERALS
+#define MARTIN_TEST_LEXER_LITERALS
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+
+namespace Martin {
+    class Test_lexer_literals : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Literals)";
+        }
+
+        bool RunTest() override {
+            // Move an escape and a comment's newlines across every offset of a vector block
+            for (size_t pad = 0; pad < 70; pad++) {
+                std::string filler(pad, 'x');
+                std::string comment = "/* " + filler + "\n*" + filler + "\n**/";
+                std::string source = comment + " \"" + filler + "\\t\\\"" + filler + "\" 'a'";
+
+                auto buffer = TokenizerSingleton.TokenizeBuffer(source);
+
+                if (buffer->Size() != 2) {
+                    error = Format("Expected 2 tokens with $ bytes of padding, got $", pad, buffer->Size());
+                    return false;
+                }
+
+                if (buffer->GetLineNumber(0) != buffer->GetLineNumber(1) || buffer->GetSpan(1) != "'a'") {
+                    error = Format("Second literal is wrong with $ bytes of padding", pad);
+                    return false;
+                }
+
+                std::string expected = filler + "\t\"" + filler;
+                if (std::string((const char*)buffer->GetBytes(0)) != expected) {
+                    error = Format("String decoded wrong with $ bytes of padding", pad);
+                    return false;
+                }
+
+                if (buffer->GetRecord(0).offset != comment.length() + 1) {
+                    error = Format("Comment ended at the wrong byte with $ bytes of padding", pad);
+                    return false;
+                }
+            }
+
+            auto lines = TokenizerSingleton.TokenizeBuffer("a /*\n\n\n*/ b");
+            if (lines->GetLineNumber(1) != lines->GetLineNumber(0) + 3) {
+                error = "Block comment didn't count its newlines";
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,233 @@
+#ifndef MARTIN_TEST_LEXER_NUMBERS
+#define MARTIN_TEST_LEXER_NUMBERS
+
+#include "testing.hpp"
+
+#include <numbers.hpp>
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+
+#include <random>
+
+namespace Martin {
+    class Test_lexer_numbers : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Numbers)";
+        }
+
+        bool RunTest() override {
+            // Every string up to 5 characters long over each radix's edge digits,
+            // the separator and a character it doesn't accept
+            const std::pair<unsigned int, std::string> alphabets[] = {
+                { 2, "01_2" },
+                { 8, "07_8" },
+                { 10, "09_a" },
+                { 16, "09afAF_g" }
+            };
+
+            for (auto& [radix, alphabet] : alphabets) {
+                for (size_t length = 0; length <= 5; length++) {
+                    std::string digits(length, alphabet[0]);
+                    std::vector<size_t> choice(length, 0);
+
+                    while (true) {
+                        if (!Compare(digits, radix))
+                            return false;
+
+                        size_t i = 0;
+                        for (; i < length; i++) {
+                            if (++choice[i] < alphabet.length()) {
+                                digits[i] = alphabet[choice[i]];
+                                break;
+                            }
+
+                            choice[i] = 0;
+                            digits[i] = alphabet[0];
+                        }
+
+                        if (i == length)
+                            break;
+                    }
+                }
+            }
+
+            // Long runs go through the eight digit steps, with the odd
+            // separator or bad digit knocking single chunks off the fast path
+            std::mt19937_64 random(1234);
+            for (auto& [radix, alphabet] : alphabets) {
+                for (size_t n = 0; n < 20000; n++) {
+                    std::string digits(random() % 40, '0');
+                    for (char& c : digits) {
+                        unsigned int pick = random() % 64;
+                        c = (pick == 0) ? '_' : (pick == 1) ? alphabet.back() : "0123456789abcdef"[pick % radix];
+                    }
+
+                    if (!Compare(digits, radix))
+                        return false;
+                }
+            }
+
+            // Around the top of UIntMax in every radix
+            for (unsigned int radix : { 2, 8, 10, 16 }) {
+                for (uintmax_t delta = 0; delta < 64; delta++) {
+                    if (!Compare(ToString(UINTMAX_MAX - delta, radix), radix))
+                        return false;
+
+                    if (!Compare(ToString(UINTMAX_MAX / radix - delta, radix) + "0", radix))
+                        return false;
+
+                    if (!Compare(ToString(UINTMAX_MAX - delta, radix) + "0", radix))
+                        return false;
+
+                    if (!Compare("1" + ToString(UINTMAX_MAX - delta, radix).substr(1), radix))
+                        return false;
+                }
+            }
+
+            // Around both ends of Int64
+            for (intmax_t delta = -4; delta < 4; delta++) {
+                std::string max = ToString(INTMAX_MAX, 10);
+                std::string min = "-" + ToString((uintmax_t)INTMAX_MAX + 1, 10);
+
+                for (std::string text : { max, min, max + "0", min + "0", std::string("-") + "0" }) {
+                    text.back() += delta;
+                    if (!CompareSigned(text))
+                        return false;
+                }
+            }
+
+            intmax_t value;
+            if ((Numbers::ParseSigned("-9223372036854775808", value) != Numbers::Result::Ok) || (value != INTMAX_MIN)) {
+                error = "Int64 minimum didn't parse";
+                return false;
+            }
+
+            // The lexer only parses literals longer than these to look for
+            // overflow, so every value that long has to fit
+            for (unsigned int radix : { 2, 8, 10, 16 }) {
+                for (bool is_signed : { false, true }) {
+                    size_t safe = Numbers::GetSafeDigits(radix, is_signed);
+                    std::string top(safe, "0123456789abcdef"[radix - 1]);
+
+                    uintmax_t magnitude;
+                    bool fits = Numbers::ParseUnsigned(top, radix, magnitude) == Numbers::Result::Ok;
+                    if (fits && is_signed)
+                        fits = magnitude <= (uintmax_t)INTMAX_MAX;
+
+                    bool fits_more = Numbers::ParseUnsigned(top + "0", radix, magnitude) == Numbers::Result::Ok;
+
+                    if (!fits || (!is_signed && fits_more)) {
+                        error = Format("$ digits of radix $ aren't the most that surely fit", safe, radix);
+                        return false;
+                    }
+                }
+            }
+
+            if ((Numbers::GetSafeDigits(10, true) + 1 != ToString(INTMAX_MAX, 10).length())) {
+                error = "Int64 takes a different number of digits than expected";
+                return false;
+            }
+
+            // Leading zeros don't count towards the digits the lexer checks
+            auto zeros = TokenizerSingleton.TokenizeBuffer("0x0000_0000_0000_0000_00ff -000000000000000000000042");
+            if ((zeros->Size() != 2) || (zeros->GetValue(0).uinteger != 0xFF) || (zeros->GetValue(1).integer != -42)) {
+                error = "Literals with leading zeros decoded to the wrong value";
+                return false;
+            }
+
+            // Hex literals used to stop at a 9
+            auto buffer = TokenizerSingleton.TokenizeBuffer("0x19 0xFFFF_FFFF_FFFF_FFFF u18446744073709551615");
+            if (buffer->Size() != 3) {
+                error = Format("Expected 3 tokens, got $", buffer->Size());
+                return false;
+            }
+
+            if ((buffer->GetValue(0).uinteger != 0x19) || (buffer->GetValue(1).uinteger != UINTMAX_MAX) || (buffer->GetValue(2).uinteger != UINTMAX_MAX)) {
+                error = "A number literal decoded to the wrong value";
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        // One digit at a time, the way the decoder used to work
+        static Numbers::Result Reference(std::string_view digits, unsigned int radix, uintmax_t& value) {
+            uintmax_t result = 0;
+
+            for (char c : digits) {
+                if (c == '_')
+                    continue;
+
+                unsigned int digit;
+                if ((c >= '0') && (c <= '9'))
+                    digit = c - '0';
+                else if ((c >= 'a') && (c <= 'f'))
+                    digit = c - 'a' + 10;
+                else if ((c >= 'A') && (c <= 'F'))
+                    digit = c - 'A' + 10;
+                else
+                    return Numbers::Result::InvalidDigit;
+
+                if (digit >= radix)
+                    return Numbers::Result::InvalidDigit;
+
+                if ((result > UINTMAX_MAX / radix) || (result * radix > UINTMAX_MAX - digit))
+                    return Numbers::Result::Overflow;
+
+                result = result * radix + digit;
+            }
+
+            value = result;
+            return Numbers::Result::Ok;
+        }
+
+        static std::string ToString(uintmax_t value, unsigned int radix) {
+            std::string text;
+
+            do {
+                text.insert(text.begin(), "0123456789abcdef"[value % radix]);
+                value /= radix;
+            } while (value);
+
+            return text;
+        }
+
+        bool Compare(const std::string& digits, unsigned int radix) {
+            uintmax_t expected = 0;
+            uintmax_t value = 0;
+
+            Numbers::Result expected_result = Reference(digits, radix, expected);
+            Numbers::Result result = Numbers::ParseUnsigned(digits, radix, value);
+
+            if ((result != expected_result) || ((result == Numbers::Result::Ok) && (value != expected))) {
+                error = Format("\"$\" in radix $ parsed differently from the reference", digits, radix);
+                return false;
+            }
+
+            return true;
+        }
+
+        bool CompareSigned(const std::string& text) {
+            bool negative = text[0] == '-';
+
+            uintmax_t magnitude = 0;
+            Numbers::Result expected_result = Reference(std::string_view(text).substr(negative ? 1 : 0), 10, magnitude);
+            if ((expected_result == Numbers::Result::Ok) && (magnitude > (uintmax_t)INTMAX_MAX + (negative ? 1 : 0)))
+                expected_result = Numbers::Result::Overflow;
+
+            intmax_t value = 0;
+            Numbers::Result result = Numbers::ParseSigned(text, value);
+
+            if ((result != expected_result) || ((result == Numbers::Result::Ok) && ((uintmax_t)value != (negative ? 0 - magnitude : magnitude)))) {
+                error = Format("\"$\" parsed differently from the reference", text);
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef MARTIN_TEST_LEXER_PARALLEL
+#define MARTIN_TEST_LEXER_PARALLEL
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <sourcebuffer.hpp>
+#include <parallel.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace Martin {
+    class Test_lexer_parallel : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Parallel)";
+        }
+
+        bool RunTest() override {
+            // Newlines, comment openers and quotes inside comments and strings
+            // are all places a chunk must not start
+            const char* lines[] = {
+                "let a : Int32 = 0x1F + 2.5 // it's \"quoted\" /* not a block\n",
+                "/* a block with // and ' and \"\n spanning\n lines */ let b := a\n",
+                "let s : String = \"line one\n// still a string /*\n\\\" done\"\n",
+                "let t := 'x\\'\n' + `tick\n` / 2 /= 3 //\n",
+                "16\"wide\" 32'wider' 8\"narrow\" true false ident_9\n"
+            };
+
+            std::string code;
+            for (size_t i = 0; code.length() < (1 << 20); i++)
+                code += lines[(i * 7) % 5];
+
+            auto source = SourceBufferBase::FromString(code);
+            auto serial = TokenizerSingleton.TokenizeBuffer(source);
+
+            for (size_t threads : {2, 3, 8}) {
+                auto parallel = TokenizerSingleton.TokenizeParallel(source, threads);
+
+                if (parallel->Size() != serial->Size()) {
+                    error = Format("$ threads gave $ tokens instead of $", threads, parallel->Size(), serial->Size());
+                    return false;
+                }
+
+                for (size_t i = 0; i < serial->Size(); i++) {
+                    const TokenRecord& a = serial->GetRecord(i);
+                    const TokenRecord& b = parallel->GetRecord(i);
+
+                    if (
+                        (a.kind != b.kind) || (a.offset != b.offset) || (a.length != b.length) ||
+                        (serial->GetLineNumber(i) != parallel->GetLineNumber(i)) ||
+                        (serial->GetName(i) != parallel->GetName(i))
+                    ) {
+                        error = Format("$ threads differ at token $: $", threads, i, parallel->GetName(i));
+                        return false;
+                    }
+                }
+            }
+
+            return TestParallelFor();
+        }
+
+    private:
+        bool TestParallelFor() {
+            // Every index once, with calls nested in the pool's threads
+            std::vector<std::atomic<size_t>> calls(1000);
+            ParallelFor(10, [&](size_t outer) {
+                ParallelFor(100, [&](size_t inner) {
+                    calls[outer * 100 + inner]++;
+                }, 4);
+            }, 4);
+
+            for (size_t i = 0; i < calls.size(); i++) {
+                if (calls[i] != 1) {
+                    error = Format("Index $ was run $ times", i, (size_t)calls[i]);
+                    return false;
+                }
+            }
+
+            // A throwing call reaches the caller and the pool keeps working
+            std::string thrown;
+            try {
+                ParallelFor(1000, [](size_t i) {
+                    if (i == 500)
+                        throw std::runtime_error("index 500");
+                }, 4);
+            } catch (const std::runtime_error& e) {
+                thrown = e.what();
+            }
+
+            if (thrown != "index 500") {
+                error = "ParallelFor didn't rethrow on the calling thread";
+                return false;
+            }
+
+            std::atomic<size_t> total(0);
+            ParallelFor(1000, [&](size_t i) { total += i; }, 4);
+
+            if (total != 999 * 1000 / 2) {
+                error = "ParallelFor lost indices after a throwing call";
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
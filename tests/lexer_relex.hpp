@@ -0,0 +1,130 @@
+#ifndef MARTIN_TEST_LEXER_RELEX
+#define MARTIN_TEST_LEXER_RELEX
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+
+#include <random>
+#include <iterator>
+
+namespace Martin {
+    class Test_lexer_relex : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Relex)";
+        }
+
+        bool RunTest() override {
+            // Comments and strings that span lines, and tokens that grow or
+            // merge when a character lands next to them
+            const char* lines[] = {
+                "let a : Int32 = 0x1F + 2.5 /* it's \"quoted\" */\n",
+                "/* a block with // and ' and \"\n spanning\n lines */ let b := a\n",
+                "let s : String = \"line one\n still a string\" + 'x' + `tick\n`\n",
+                "16\"wide\" 32'wider' 8\"narrow\" true false ident9 == -42 1.5f\n"
+            };
+
+            std::string code;
+            for (size_t i = 0; i < 20; i++)
+                code += lines[(i * 3) % 4];
+
+            // Decoded literals carry over to the relexed buffer
+            auto base = TokenizerSingleton.TokenizeBuffer(code);
+            for (size_t i = 0; i < base->Size(); i++)
+                base->GetName(i);
+
+            std::mt19937 random(42);
+
+            // Single edits of the base. Nothing gets removed that would open
+            // or close a comment or string
+            const char* snippets[] = { "x", "1", "9", ".", "y", "0x", "f", "-", "=", " ", "\n", "", "/* c */", "\"s\"", "// c\n" };
+
+            for (size_t n = 0; n < 2000; n++) {
+                size_t offset, removed;
+                PickEdit(random, base->GetSource(), offset, removed);
+
+                size_t snippet = random() % std::size(snippets);
+
+                // Comments and strings go in at a token start, inside another
+                // one they would close it early
+                if (snippet >= 12) {
+                    offset = base->GetRecord(random() % base->Size()).offset;
+                    removed = 0;
+                }
+
+                if (!Compare(base, offset, removed, snippets[snippet]))
+                    return false;
+            }
+
+            // A chain of edits, each relexing the last result
+            auto buffer = base;
+            for (size_t n = 0; n < 300; n++) {
+                size_t offset, removed;
+                PickEdit(random, buffer->GetSource(), offset, removed);
+
+                std::string inserted = snippets[random() % 12];
+                if (!Compare(buffer, offset, removed, inserted))
+                    return false;
+
+                buffer = TokenizerSingleton.Relex(buffer, offset, removed, inserted);
+                for (size_t i = 0; i < buffer->Size(); i++)
+                    buffer->GetName(i);
+            }
+
+            return true;
+        }
+
+    private:
+        static bool IsDelimiter(char c) {
+            return (c == '/') || (c == '*') || (c == '\\') || (c == '\"') || (c == '\'') || (c == '`');
+        }
+
+        // Up to 8 bytes anywhere that doesn't touch a comment or string delimiter
+        static void PickEdit(std::mt19937& random, std::string_view source, size_t& offset, size_t& removed) {
+            while (true) {
+                offset = random() % (source.length() + 1);
+                removed = std::min((size_t)(random() % 9), source.length() - offset);
+
+                bool valid = ((offset == 0) || !IsDelimiter(source[offset - 1])) && ((offset + removed == source.length()) || !IsDelimiter(source[offset + removed]));
+                for (size_t i = offset; i < offset + removed; i++)
+                    valid = valid && !IsDelimiter(source[i]);
+
+                if (valid)
+                    return;
+            }
+        }
+
+        bool Compare(TokenBuffer previous, size_t offset, size_t removed, std::string_view inserted) {
+            std::string code(previous->GetSource());
+            code.replace(offset, removed, inserted);
+
+            auto expected = TokenizerSingleton.TokenizeBuffer(code);
+            auto relexed = TokenizerSingleton.Relex(previous, offset, removed, inserted);
+
+            if ((relexed->GetSource() != expected->GetSource()) || (relexed->Size() != expected->Size())) {
+                error = Format("Replacing $ bytes at $ with \"$\" gave $ tokens instead of $", removed, offset, std::string(inserted), relexed->Size(), expected->Size());
+                return false;
+            }
+
+            for (size_t i = 0; i < expected->Size(); i++) {
+                const TokenRecord& a = expected->GetRecord(i);
+                const TokenRecord& b = relexed->GetRecord(i);
+
+                if (
+                    (a.kind != b.kind) || (a.offset != b.offset) || (a.length != b.length) ||
+                    (expected->GetLineNumber(i) != relexed->GetLineNumber(i)) ||
+                    (expected->GetName(i) != relexed->GetName(i))
+                ) {
+                    error = Format("Replacing $ bytes at $ with \"$\" differs at token $: $", removed, offset, std::string(inserted), i, relexed->GetName(i));
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef MARTIN_TEST_LEXER_SOURCEBUFFER
+#define MARTIN_TEST_LEXER_SOURCEBUFFER
+
+#include "testing.hpp"
+
+#include <sourcebuffer.hpp>
+#include <tokenbuffer.hpp>
+#include <parse.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+
+namespace Martin {
+    class Test_lexer_sourcebuffer : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(SourceBuffer)";
+        }
+
+        bool RunTest() override {
+            const std::string code = "let a : Int32 = 3\n";
+            std::string path = (std::filesystem::temp_directory_path() / "martin_sourcebuffer_test.martin").string();
+
+            std::ofstream file(path, std::ios::binary);
+            file << code;
+            file.close();
+
+            bool result = CheckFile(path, code);
+            std::remove(path.c_str());
+
+            if (!result)
+                return false;
+
+            auto copied = SourceBufferBase::FromString(code);
+            if ((copied->GetView() != code) || !HasPadding(copied)) {
+                error = "String source wasn't copied with padding";
+                return false;
+            }
+
+            std::string missing_error;
+            if (SourceBufferBase::FromFile(path, missing_error) || missing_error.empty()) {
+                error = "Opening a missing file didn't fail";
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        bool HasPadding(SourceBuffer source) {
+            for (size_t i = 0; i < SourceBufferBase::padding; i++) {
+                if (source->GetData()[source->GetSize() + i] != '\0')
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool CheckFile(const std::string& path, const std::string& code) {
+            auto source = SourceBufferBase::FromFile(path, error);
+            if (!source)
+                return false;
+
+            if (source->GetView() != code) {
+                error = "Mapped source doesn't match the file";
+                return false;
+            }
+
+            if (!HasPadding(source)) {
+                error = "Mapped source isn't followed by zero padding";
+                return false;
+            }
+
+            auto buffer = TokenizerSingleton.TokenizeBuffer(source);
+            if ((buffer->Size() != 6) || (buffer->GetSource().data() != source->GetData())) {
+                error = "Tokenizer didn't lex the source in place";
+                return false;
+            }
+
+            auto tree = ParserSingleton.ParseFile(path, error);
+            if (!tree) {
+                if (error.empty())
+                    error = "ParseFile returned a nullptr";
+                
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
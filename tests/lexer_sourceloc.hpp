@@ -0,0 +1,214 @@
+#ifndef MARTIN_TEST_LEXER_SOURCELOC
+#define MARTIN_TEST_LEXER_SOURCELOC
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <sourcebuffer.hpp>
+#include <parse.hpp>
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <set>
+
+namespace Martin {
+    class Test_lexer_sourceloc : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(SourceLoc)";
+        }
+
+        bool RunTest() override {
+            if (!TestLineTable()) return false;
+            if (!TestTokens()) return false;
+            if (!TestNodes()) return false;
+            if (!TestFreed()) return false;
+            if (!TestReuse()) return false;
+            if (!TestThreads()) return false;
+
+            return true;
+        }
+
+    private:
+        bool TestLineTable() {
+            std::string code;
+            for (size_t i = 0; i < 300; i++) {
+                code += std::string(i % 23, ' ') + "x";
+                code += (i % 5 == 0) ? "\n\n" : "\n";
+            }
+
+            auto source = SourceBufferBase::FromString(code);
+
+            unsigned int line = 1;
+            unsigned int column = 1;
+            for (size_t offset = 0; offset < code.size(); offset++) {
+                if ((source->GetLine(offset) != line) || (source->GetColumn(offset) != column)) {
+                    error = Format("Offset $ is at $:$, expected $:$", offset, source->GetLine(offset), source->GetColumn(offset), line, column);
+                    return false;
+                }
+
+                SourceLoc loc = source->GetLoc(offset);
+                if ((GetLine(loc) != line) || (GetColumn(loc) != column)) {
+                    error = Format("SourceLoc of offset $ is at $:$", offset, GetLine(loc), GetColumn(loc));
+                    return false;
+                }
+
+                if (code[offset] == '\n') {
+                    line++;
+                    column = 1;
+                } else {
+                    column++;
+                }
+            }
+
+            return true;
+        }
+
+        bool TestTokens() {
+            std::string code = "let a := 1\n  /* x\n y */ b\n\n\t\"s\" c";
+            TokenList tokens = TokenizerSingleton.TokenizeString(code);
+            if (!tokens || tokens->size() != 7) {
+                error = "Expected 7 tokens";
+                return false;
+            }
+
+            const unsigned int expected[][2] = { { 1, 1 }, { 1, 5 }, { 1, 7 }, { 1, 10 }, { 3, 7 }, { 5, 2 }, { 5, 6 } };
+
+            for (size_t i = 0; i < tokens->size(); i++) {
+                Token token = (*tokens)[i];
+                if ((token->GetLineNumber() != expected[i][0]) || (token->GetColumn() != expected[i][1])) {
+                    error = Format("Token $ is at $:$, expected $:$", i, token->GetLineNumber(), token->GetColumn(), expected[i][0], expected[i][1]);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool TestNodes() {
+            TokenList tokens = TokenizerSingleton.TokenizeString("\n\n  a + b");
+            if (!tokens) {
+                error = "Tokenizer failed";
+                return false;
+            }
+
+            Parser parser;
+            Tree tree = parser.ParseTokens(tokens);
+            if (!tree || tree->size() != 1 || (*tree)[0]->is_token) {
+                error = "Expected a single node";
+                return false;
+            }
+
+            TreeNode node = (*tree)[0]->node;
+            if ((node->GetLineNumber() != 3) || (node->GetColumn() != 5)) {
+                error = Format("Node is at $:$, expected 3:5", node->GetLineNumber(), node->GetColumn());
+                return false;
+            }
+
+            return true;
+        }
+
+        bool TestFreed() {
+            auto source = SourceBufferBase::FromString("a\nb");
+            SourceLoc loc = source->GetLoc(2);
+
+            if (GetLine(loc) != 2 || SourceBufferBase::FromFileID(loc.file) != source) {
+                error = "SourceLoc doesn't find its source";
+                return false;
+            }
+
+            source = nullptr;
+
+            if (GetLine(loc) != 0 || GetColumn(loc) != 0 || SourceBufferBase::FromFileID(loc.file)) {
+                error = "SourceLoc still finds a freed source";
+                return false;
+            }
+
+            if (GetLine(SourceLoc()) != 0) {
+                error = "Invalid SourceLoc has a line";
+                return false;
+            }
+
+            return true;
+        }
+
+        bool TestReuse() {
+            const size_t sources = 20000;
+            const FileID mask = (1u << FileSlotBits) - 1;
+
+            SourceLoc first = SourceBufferBase::FromString("a\nb")->GetLoc(2);
+            std::set<FileID> slots;
+            bool reused = false;
+
+            for (size_t i = 0; i < sources; i++) {
+                auto source = SourceBufferBase::FromString("a\nb");
+                SourceLoc loc = source->GetLoc(2);
+
+                if (GetLine(loc) != 2) {
+                    error = Format("Source $ lost its line", i);
+                    return false;
+                }
+
+                slots.insert(loc.file & mask);
+                reused |= ((loc.file & mask) == (first.file & mask));
+            }
+
+            if (slots.size() >= sources / 2) {
+                error = Format("$ sources in a row took $ slots", sources, slots.size());
+                return false;
+            }
+
+            if (!reused || GetLine(first) || SourceBufferBase::FromFileID(first.file)) {
+                error = "A freed source's slot isn't reused or its old location finds the new source";
+                return false;
+            }
+
+            return true;
+        }
+
+        bool TestThreads() {
+            const size_t rounds = 5000;
+            const size_t readers = 4;
+
+            // One thread keeps freeing sources while the others look up the last one
+            std::atomic<uint64_t> latest(InvalidFileID);
+            std::atomic<bool> done(false);
+            std::atomic<size_t> wrong(0);
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < readers; t++) {
+                threads.push_back(std::thread([&]() {
+                    while (!done) {
+                        uint64_t packed = latest.load();
+                        SourceLoc loc = { (FileID)packed, (uint32_t)(packed >> 32) };
+                        unsigned int line = GetLine(loc);
+
+                        if (line && (line != 2 || GetColumn(loc) > 1))
+                            wrong++;
+                    }
+                }));
+            }
+
+            for (size_t i = 0; i < rounds; i++) {
+                auto source = SourceBufferBase::FromString("a\nb");
+                SourceLoc loc = source->GetLoc(2);
+                latest = loc.file | ((uint64_t)loc.offset << 32);
+            }
+
+            done = true;
+            for (auto& thread : threads)
+                thread.join();
+
+            if (wrong) {
+                error = Format("$ lookups raced with a freed source", (size_t)wrong);
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
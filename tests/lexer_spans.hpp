@@ -0,0 +1,51 @@
+#ifndef MARTIN_TEST_LEXER_SPANS
+#define MARTIN_TEST_LEXER_SPANS
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+
+#include "helpers/validatetree.hpp"
+
+namespace Martin {
+    class Test_lexer_spans : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Spans)";
+        }
+
+        bool RunTest() override {
+            const std::string source = "let abc := 0x1F // comment\n\"str\" /* a */ 2.5f";
+            auto tree = TokenizerSingleton.TokenizeString(source);
+
+            if (!ValidateTokenList(tree, error, 6)) return false;
+
+            const size_t spans[][2] = {
+                {0, 3},
+                {4, 7},
+                {8, 10},
+                {11, 15},
+                {27, 32},
+                {41, 45}
+            };
+
+            for (size_t i = 0; i < tree->size(); i++) {
+                Token token = (*tree)[i];
+
+                if ((token->GetBegin() != spans[i][0]) || (token->GetEnd() != spans[i][1])) {
+                    error = Format("Token $ spans [$, $) when expecting [$, $)", i, token->GetBegin(), token->GetEnd(), spans[i][0], spans[i][1]);
+                    return false;
+                }
+            }
+
+            if (source != "let abc := 0x1F // comment\n\"str\" /* a */ 2.5f") {
+                error = "Tokenizer modified its input";
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef MARTIN_TEST_LEXER_THREADS
+#define MARTIN_TEST_LEXER_THREADS
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+
+#include <thread>
+#include <atomic>
+#include <vector>
+
+namespace Martin {
+    class Test_lexer_threads : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(Threads)";
+        }
+
+        bool RunTest() override {
+            const size_t files = 400;
+            const size_t threads = 8;
+
+            std::atomic<size_t> next(0);
+            std::atomic<size_t> failed(files);
+            std::vector<std::thread> workers;
+
+            for (size_t t = 0; t < threads; t++) {
+                workers.push_back(std::thread([&, t]() {
+                    // Half the threads share the singleton, the others use their own tokenizer
+                    Tokenizer own;
+                    Tokenizer& tokenizer = (t % 2) ? own : TokenizerSingleton;
+
+                    for (size_t file = next++; file < files; file = next++) {
+                        if (!CheckFile(tokenizer, file))
+                            failed = file;
+                    }
+                }));
+            }
+
+            for (auto& worker : workers)
+                worker.join();
+
+            if (failed != files) {
+                error = Format("File $ got the wrong line numbers", (size_t)failed);
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        // Line i of a file holds one identifier after i % 3 extra lines of
+        // comments and strings, so every line number is known up front
+        static bool CheckFile(Tokenizer& tokenizer, size_t file) {
+            std::string source;
+            std::vector<unsigned int> lines;
+            unsigned int line = 1;
+
+            for (size_t i = 0; i < 50 + file % 7; i++) {
+                switch ((i + file) % 3) {
+                    case 1:
+                        source += "/* a\nb */ ";
+                        line++;
+                        break;
+
+                    case 2:
+                        source += "\"x\ny\" ";
+                        lines.push_back(line++);
+                        break;
+                }
+
+                source += "name" + std::to_string(i) + "\n";
+                lines.push_back(line++);
+            }
+
+            auto buffer = tokenizer.TokenizeBuffer(source);
+            if (buffer->Size() != lines.size())
+                return false;
+
+            for (size_t i = 0; i < lines.size(); i++) {
+                if (buffer->GetLineNumber(i) != lines[i])
+                    return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
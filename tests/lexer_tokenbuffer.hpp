@@ -0,0 +1,92 @@
+#ifndef MARTIN_TEST_LEXER_TOKENBUFFER
+#define MARTIN_TEST_LEXER_TOKENBUFFER
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <parse.hpp>
+
+#include "helpers/validatetree.hpp"
+
+namespace Martin {
+    class Test_lexer_tokenbuffer : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(TokenBuffer)";
+        }
+
+        bool RunTest() override {
+            auto buffer = TokenizerSingleton.TokenizeBuffer("let abc := 0x1F\n\"str\" true 2.5f");
+
+            if (buffer->Size() != 7) {
+                error = Format("Expected 7 records, got $", buffer->Size());
+                return false;
+            }
+
+            const TokenType::Type kinds[] = {
+                TokenType::Type::KW_Let,
+                TokenType::Type::Identifier,
+                TokenType::Type::SYM_TypeAssign,
+                TokenType::Type::UInteger,
+                TokenType::Type::String8,
+                TokenType::Type::Boolean,
+                TokenType::Type::FloatingSingle
+            };
+
+            for (size_t i = 0; i < 7; i++) {
+                if (buffer->GetType(i) != kinds[i]) {
+                    error = Format("Record $ has kind $", i, buffer->GetName(i));
+                    return false;
+                }
+            }
+
+            if (std::string((const char*)buffer->GetBytes(1)) != "abc") {
+                error = "Identifier bytes don't match";
+                return false;
+            }
+
+            if (buffer->GetValue(3).uinteger != 0x1F) {
+                error = "UInteger value doesn't match";
+                return false;
+            }
+
+            if ((buffer->GetSpan(4) != "\"str\"") || (buffer->GetLineNumber(4) != buffer->GetLineNumber(0) + 1)) {
+                error = "String span or line doesn't match";
+                return false;
+            }
+
+            if (buffer->GetRecord(5).payload != 1) {
+                error = "Boolean payload doesn't match";
+                return false;
+            }
+
+            auto tokens = CreateTokenList(buffer);
+            if (!ValidateTokenList(tokens, error, 7)) return false;
+
+            auto value = std::static_pointer_cast<uintmax_t>((*tokens)[3]->GetData());
+            if (*value != 0x1F) {
+                error = "Token view returned the wrong value";
+                return false;
+            }
+
+            buffer.reset();
+            if ((*tokens)[1]->GetName() != "Identifier abc") {
+                error = "Token view didn't keep its buffer alive";
+                return false;
+            }
+
+            // Data outlives the list and its tokens
+            auto bytes = std::static_pointer_cast<uint8_t[]>((*tokens)[1]->GetData());
+            tokens = nullptr;
+            if (std::string((const char*)bytes.get()) != "abc") {
+                error = "Token data didn't keep its buffer alive";
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef MARTIN_TEST_LEXER_TOKENCACHE
+#define MARTIN_TEST_LEXER_TOKENCACHE
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <tokencache.hpp>
+#include <hash.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <cstring>
+
+namespace Martin {
+    class Test_lexer_tokencache : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(TokenCache)";
+        }
+
+        bool RunTest() override {
+            // Reference values of XXH64
+            if ((Hash64("") != 0xEF46DB3751D8E999) || (Hash64("abc") != 0x44BC2CF5AD770999)) {
+                error = "Hash64 doesn't match XXH64";
+                return false;
+            }
+
+            std::string directory = (std::filesystem::temp_directory_path() / ("martin-tokencache-" + std::to_string(std::random_device()()))).string();
+            bool result = RunInDirectory(directory);
+
+            std::error_code ignored;
+            std::filesystem::remove_all(directory, ignored);
+
+            return result;
+        }
+
+    private:
+        bool RunInDirectory(const std::string& directory) {
+            TokenCache cache(directory);
+
+            std::string code;
+            for (size_t i = 0; i < 50; i++) {
+                code += "func f" + std::to_string(i) + "(let x : Int32) -> Float64 { /* block\n */\n";
+                code += "    return x * 0x" + std::to_string(i) + "F + -" + std::to_string(i) + " - 2.5 + 1.5f // \"done\"\n";
+                code += "    let s : String = \"text\\n" + std::to_string(i) + "\" + 16\"wide\" + true\n}\n";
+            }
+
+            auto source = SourceBufferBase::FromString(code);
+            auto expected = TokenizerSingleton.TokenizeBuffer(source);
+
+            if (cache.Load(source)) {
+                error = "Empty cache had an entry";
+                return false;
+            }
+
+            auto stored = cache.Tokenize(source);
+            auto loaded = cache.Load(source);
+
+            if (!loaded) {
+                error = "Entry wasn't stored";
+                return false;
+            }
+
+            for (auto buffer : { stored, loaded }) {
+                if (buffer->Size() != expected->Size()) {
+                    error = Format("Cache gave $ tokens instead of $", buffer->Size(), expected->Size());
+                    return false;
+                }
+
+                for (size_t i = 0; i < expected->Size(); i++) {
+                    const TokenRecord& a = expected->GetRecord(i);
+                    const TokenRecord& b = buffer->GetRecord(i);
+
+                    if (
+                        (a.kind != b.kind) || (a.offset != b.offset) || (a.length != b.length) ||
+                        (expected->GetLineNumber(i) != buffer->GetLineNumber(i)) ||
+                        (expected->GetName(i) != buffer->GetName(i)) ||
+                        (expected->GetSymbol(i) != buffer->GetSymbol(i))
+                    ) {
+                        error = Format("Cached token $ differs: $", i, buffer->GetName(i));
+                        return false;
+                    }
+                }
+            }
+
+            // One changed byte is another entry
+            std::string changed = code;
+            changed[changed.find("0x")] = '1';
+
+            if (cache.Load(SourceBufferBase::FromString(changed))) {
+                error = "Changed source loaded the old entry";
+                return false;
+            }
+
+            // An entry whose hash collides with the source's, made by giving
+            // the changed source's entry the hash of the original
+            auto other = SourceBufferBase::FromString(changed);
+            cache.Tokenize(other);
+
+            std::string path = cache.GetEntryPath(TokenCache::GetKey(code));
+            std::filesystem::copy_file(cache.GetEntryPath(TokenCache::GetKey(changed)), path, std::filesystem::copy_options::overwrite_existing);
+            {
+                // The hash follows the magic, format, compiler version and a reserved word
+                uint64_t key = TokenCache::GetKey(code);
+                std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+                file.seekp(32);
+                file.write((const char*)&key, sizeof(key));
+            }
+
+            if (cache.Load(source)) {
+                error = "Entry of another source with the same hash was loaded";
+                return false;
+            }
+
+            cache.Store(*expected);
+
+            // So does one with a kind past the last token type, or with counts
+            // that only match the entry's size once their byte sizes overflow
+            std::string entry;
+            {
+                std::ifstream file(path, std::ios::binary);
+                entry.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+
+            // The header is 88 bytes, the first record's kind 12 bytes into it
+            if (!Damaged(cache, source, path, entry, 100, (uint32_t)TokenType::TypeCount))
+                return false;
+
+            // token_count follows the hash, check and source size
+            uint64_t count;
+            std::memcpy(&count, entry.data() + 56, sizeof(count));
+            if (!Damaged(cache, source, path, entry, 56, count + ((uint64_t)1 << 60)))
+                return false;
+
+            // A damaged entry gets ignored
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+
+            if (cache.Load(source)) {
+                error = "Truncated entry was loaded";
+                return false;
+            }
+
+            if (cache.Tokenize(source)->Size() != expected->Size() || !cache.Load(source)) {
+                error = "Truncated entry wasn't replaced";
+                return false;
+            }
+
+            return true;
+        }
+
+        template <typename T>
+        bool Damaged(const TokenCache& cache, SourceBuffer source, const std::string& path, std::string entry, size_t offset, T value) {
+            std::memcpy(entry.data() + offset, &value, sizeof(value));
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << entry;
+
+            if (cache.Load(source)) {
+                error = Format("Entry damaged at byte $ was loaded", offset);
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
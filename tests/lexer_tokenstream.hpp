@@ -0,0 +1,91 @@
+#ifndef MARTIN_TEST_LEXER_TOKENSTREAM
+#define MARTIN_TEST_LEXER_TOKENSTREAM
+
+#include "testing.hpp"
+
+#include <tokens.hpp>
+#include <tokenbuffer.hpp>
+#include <tokenstream.hpp>
+#include <parse.hpp>
+
+namespace Martin {
+    class Test_lexer_tokenstream : public Test {
+    public:
+        std::string GetName() const override {
+            return "Lexer(TokenStream)";
+        }
+
+        bool RunTest() override {
+            std::string code;
+            for (size_t i = 0; i < 200; i++) {
+                code += "func add" + std::to_string(i) + "(let nums : array[-1] Int32) -> Int32 {\n";
+                code += "    let total : Int32 = 0x1F /* a block\n comment */\n";
+                code += "    total += nums.get(" + std::to_string(i) + ") * 2.5 // \"done\"\n";
+                code += "    return total\n";
+                code += "}\n";
+            }
+
+            auto source = SourceBufferBase::FromString(code);
+            auto buffer = TokenizerSingleton.TokenizeBuffer(source);
+
+            // Capacities down to a single token of lookahead, and ones bigger than the source
+            for (size_t capacity : { 2, 3, 64, 1 << 16 }) {
+                for (bool pipelined : { false, true }) {
+                    TokenStream stream = TokenStream(new TokenStreamBase(source, capacity, pipelined));
+                    size_t ahead = (capacity / 2) - 1;
+
+                    for (size_t i = 0; i < buffer->Size(); i++) {
+                        Token peeked = stream->Peek(ahead);
+                        bool peek_valid = (i + ahead < buffer->Size()) ? (peeked && (peeked->GetName() == buffer->GetName(i + ahead))) : !peeked;
+
+                        Token token = stream->Next();
+                        if (
+                            !peek_valid || !token ||
+                            (token->GetType() != buffer->GetType(i)) ||
+                            (token->GetLineNumber() != buffer->GetLineNumber(i)) ||
+                            (token->GetName() != buffer->GetName(i))
+                        ) {
+                            error = Format("Stream of capacity $ differs from the buffer at token $", capacity, i);
+                            return false;
+                        }
+                    }
+
+                    if (stream->Next() || stream->Peek()) {
+                        error = Format("Stream of capacity $ has tokens past the end", capacity);
+                        return false;
+                    }
+                }
+            }
+
+            // Dropping a stream part way has to stop its lexing thread
+            {
+                TokenStream stream = TokenStream(new TokenStreamBase(source, 8));
+                stream->Next();
+            }
+
+            // Parsing from a stream builds the same tree
+            Tree expected = ParserSingleton.ParseTokens(buffer);
+            Tree streamed = ParserSingleton.ParseTokens(TokenStream(new TokenStreamBase(source, 256)));
+
+            if (expected->size() != streamed->size()) {
+                error = Format("Streamed tree has $ nodes instead of $", streamed->size(), expected->size());
+                return false;
+            }
+
+            for (size_t i = 0; i < expected->size(); i++) {
+                std::string a, b;
+                (*expected)[i]->Serialize(a);
+                (*streamed)[i]->Serialize(b);
+
+                if (a != b) {
+                    error = Format("Streamed tree differs at node $: $", i, b);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef MARTIN_TEST_TREE_ARENA
+#define MARTIN_TEST_TREE_ARENA
+
+#include "testing.hpp"
+
+#include <arena.hpp>
+#include <parse.hpp>
+#include <flattree.hpp>
+#include <lambda.hpp>
+#include <generators/enclosures.hpp>
+
+namespace Martin {
+    class Test_tree_arena : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(Arena)";
+        }
+
+        bool RunTest() override {
+            size_t destroyed = 0;
+
+            {
+                AstArena arena;
+
+                for (size_t i = 0; i < 10000; i++) {
+                    std::shared_ptr<Counted> object = arena.Make<Counted>(destroyed);
+                    if (object.use_count() != 0) {
+                        error = "Arena handles own their objects";
+                        return false;
+                    }
+                }
+
+                // Bigger than a block
+                arena.Make<Large>();
+
+                AstArena::Stats stats = arena.GetStats();
+                if ((stats.objects != 10001) || (stats.blocks < 2) || (stats.bytes < sizeof(Large))) {
+                    error = Format("Arena stats are $ objects, $ blocks, $ bytes", stats.objects, stats.blocks, stats.bytes);
+                    return false;
+                }
+
+                if (destroyed) {
+                    error = "Objects got destroyed before their arena";
+                    return false;
+                }
+            }
+
+            if (destroyed != 10000) {
+                error = Format("Arena destroyed $ of 10000 objects", destroyed);
+                return false;
+            }
+
+            AstArena outer, inner;
+            {
+                AstArena::Scope outer_scope(&outer);
+                {
+                    AstArena::Scope inner_scope(&inner);
+                    MakeTokenNode();
+                }
+                MakeTokenNode();
+                MakeTokenNode();
+            }
+
+            if ((AstArena::GetCurrent() != nullptr) || (inner.GetStats().objects != 1) || (outer.GetStats().objects != 2)) {
+                error = "Arena scopes don't nest";
+                return false;
+            }
+
+            // Items taken from a parsed tree keep its nodes alive
+            TokenNode item;
+            {
+                Tree tree = ParserSingleton.ParseString("let a : Int32 = b + (c * d)", error);
+                if (!tree || (tree->size() != 1)) {
+                    error = "Couldn't parse a definition";
+                    return false;
+                }
+
+                item = (*tree)[0];
+            }
+
+            std::string serial;
+            item->Serialize(serial);
+            if (serial.find("*") == std::string::npos) {
+                error = Format("Node outlived by its item serialized to $", serial);
+                return false;
+            }
+
+            // Nodes looked up in a tree outlive it, in every way of looking
+            // them up, and let the arena go once they're gone
+            if (!LookUp([](Tree tree) {
+                return Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::OP_Add);
+            }, "the node index"))
+                return false;
+
+            if (!LookUp([](Tree tree) {
+                tree->SetIndex(nullptr);
+                return Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::OP_Add);
+            }, "a walk"))
+                return false;
+
+            if (!LookUp([](Tree tree) {
+                FlatTree flat = FlatTree(new FlatTreeBase(tree));
+                std::vector<TreeNode> nodes = flat->GetAllNodesOfType(TreeNodeBase::Type::OP_Add);
+
+                for (FlatTreeBase::Index index = 0; index < flat->size(); index++) {
+                    if (!flat->IsToken(index) && (flat->GetType(index) == TreeNodeBase::Type::OP_Add))
+                        nodes.push_back(flat->GetItem(index)->node);
+                }
+
+                return nodes;
+            }, "a flat tree"))
+                return false;
+
+            if (!LookUp([](Tree tree) {
+                TreeNode curly = Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::Struct_Curly)[0];
+                return Parser::GetAllNodesOfType(std::static_pointer_cast<StructCurlyTreeNode>(curly)->inside, TreeNodeBase::Type::OP_Add);
+            }, "the tree inside braces"))
+                return false;
+
+            if (!LookUp([](Tree tree) {
+                ProcessLambdas(tree, "arena");
+
+                // The function made for the lambda
+                std::vector<TreeNode> nodes;
+                nodes.push_back((*tree)[tree->size() - 1]->node);
+                return nodes;
+            }, "lambdas"))
+                return false;
+
+            // Parses inside a caller's arena leave it to the caller
+            AstArena arena;
+            {
+                AstArena::Scope scope(&arena);
+                Tree tree = ParserSingleton.ParseString("a + b", error);
+
+                if (!tree || (tree->size() != 1) || ((*tree)[0].use_count() != 0)) {
+                    error = "Parse in a caller's arena handed out owning items";
+                    return false;
+                }
+            }
+
+            if (arena.GetStats().objects < 4) {
+                error = Format("Caller's arena holds $ objects after a parse", arena.GetStats().objects);
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        template <typename F>
+        bool LookUp(F look_up, const std::string& name) {
+            std::vector<TreeNode> nodes;
+            std::weak_ptr<AstArena> arena;
+
+            {
+                Tree tree = ParserSingleton.ParseString("func f() { let a = 1 + 2 let g := lambda () { return b + c } }", error);
+                if (!tree || !tree->GetArena()) {
+                    error = "Parse gave a tree without an arena";
+                    return false;
+                }
+
+                arena = tree->GetArena();
+                nodes = look_up(tree);
+            }
+
+            if (nodes.empty() || arena.expired()) {
+                error = Format("Nodes found through $ didn't keep the arena alive", name);
+                return false;
+            }
+
+            for (auto node : nodes) {
+                std::string serial;
+                node->Serialize(serial);
+
+                if (serial.find("+") == std::string::npos && serial.find("Func") == std::string::npos) {
+                    error = Format("Node found through $ serialized to $", name, serial);
+                    return false;
+                }
+            }
+
+            nodes.clear();
+            if (!arena.expired()) {
+                error = Format("Nodes found through $ keep the arena alive after they're gone", name);
+                return false;
+            }
+
+            return true;
+        }
+
+        struct Counted {
+            Counted(size_t& destroyed) : destroyed(destroyed) {}
+            ~Counted() { destroyed++; }
+
+            size_t& destroyed;
+        };
+
+        struct Large {
+            char data[1 << 17];
+        };
+    };
+}
+
+#endif
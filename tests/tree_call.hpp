@@ -49,9 +49,9 @@ namespace Martin {
                 args->node = op;
             }
 
-            SUBTEST("a(b)", a->token, args, CallTreeNode, true);
+            SUBTEST("a(b)", a, args, CallTreeNode, true);
             SUBTEST("nullptr(b)", nullptr, args, CallTreeNode, false);
-            SUBTEST("a(nullptr)", a->token, nullptr, CallTreeNode, false);
+            SUBTEST("a(nullptr)", a, nullptr, CallTreeNode, false);
             SUBTEST("nullptr(nullptr)", nullptr, nullptr, CallTreeNode, false);
 
             return true;
@@ -0,0 +1,117 @@
+#ifndef MARTIN_TEST_TREE_FLATTREE
+#define MARTIN_TEST_TREE_FLATTREE
+
+#include "testing.hpp"
+
+#include <flattree.hpp>
+#include <parse.hpp>
+
+namespace Martin {
+    class Test_tree_flattree : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(FlatTree)";
+        }
+
+        bool RunTest() override {
+            std::string code;
+            code += "func add(let nums : array[-1] Int32) -> Int32 {\n";
+            code += "    let total : Int32 = 0\n";
+            code += "    for (let i := 0, i < nums.count(), i += 1) {\n";
+            code += "        total += nums.get(i) * 3 + 0x1F - 2.5\n";
+            code += "    }\n";
+            code += "    let f := lambda (let x : Int32) -> Int32 { return x * (x + 1) }\n";
+            code += "    if (total > 3 and not false) { return f(total) }\n";
+            code += "    return total\n";
+            code += "}\n";
+            code += "struct Point { let x : Float32 let y : Float32 }\n";
+            code += "from math import sqrt, pow as power\n";
+
+            Tree tree = ParserSingleton.ParseString(code, error);
+            if (!tree) {
+                error = "Couldn't parse the code";
+                return false;
+            }
+
+            FlatTree flat = FlatTree(new FlatTreeBase(tree));
+
+            for (size_t type = 0; type < TreeNodeBase::TypeCount; type++) {
+                auto expected = Parser::GetAllNodesOfType(tree, (TreeNodeBase::Type)type);
+                auto found = flat->GetAllNodesOfType((TreeNodeBase::Type)type);
+
+                if (expected != found) {
+                    error = Format("Flat tree found $ nodes of type $, expected $", found.size(), type, expected.size());
+                    return false;
+                }
+            }
+
+            if (flat->GetRoots().size() != tree->size()) {
+                error = Format("Flat tree has $ roots for $ items", flat->GetRoots().size(), tree->size());
+                return false;
+            }
+
+            for (FlatTreeBase::Index index = 0; index < flat->size(); index++) {
+                const TokenNode& item = flat->GetItem(index);
+
+                if (flat->IsToken(index) != item->is_token) {
+                    error = Format("Item $ is the wrong kind", index);
+                    return false;
+                }
+
+                if (item->is_token) {
+                    if ((flat->GetToken(index) != item->token) || (flat->GetTokenType(index) != item->token->GetType()) || flat->GetChildCount(index)) {
+                        error = Format("Token $ doesn't match its item", index);
+                        return false;
+                    }
+                    continue;
+                }
+
+                std::vector<TokenNode> all, children;
+                item->node->GetChildren(all);
+
+                // Like types in "let a := 0"
+                for (auto child : all) {
+                    if (child)
+                        children.push_back(child);
+                }
+
+                if ((flat->GetType(index) != item->node->GetType()) || (flat->GetChildCount(index) != children.size())) {
+                    error = Format("Node $ doesn't match its item", index);
+                    return false;
+                }
+
+                FlatTreeBase::Index next = index + 1;
+                for (size_t i = 0; i < children.size(); i++) {
+                    FlatTreeBase::Index child = flat->GetChild(index, i);
+
+                    // Children follow their parent one subtree after the other
+                    if ((flat->GetItem(child) != children[i]) || (flat->GetParent(child) != index) || (child != next)) {
+                        error = Format("Child $ of node $ is out of place", i, index);
+                        return false;
+                    }
+
+                    next = flat->GetSubtreeEnd(child);
+                }
+
+                if (flat->GetSubtreeEnd(index) != next) {
+                    error = Format("Subtree of node $ ends at $, expected $", index, flat->GetSubtreeEnd(index), next);
+                    return false;
+                }
+            }
+
+            // Deep nesting doesn't need a deep call stack
+            const size_t depth = 3000;
+            Tree nested = ParserSingleton.ParseString(std::string(depth, '(') + "a" + std::string(depth, ')'), error);
+            FlatTree flat_nested = FlatTree(new FlatTreeBase(nested));
+
+            if ((flat_nested->size() != depth + 1) || (flat_nested->GetSubtreeEnd(0) != depth + 1) || !flat_nested->IsToken(depth)) {
+                error = Format("Nested parentheses flattened to $ items", flat_nested->size());
+                return false;
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
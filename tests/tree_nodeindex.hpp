@@ -0,0 +1,88 @@
+#ifndef MARTIN_TEST_TREE_NODEINDEX
+#define MARTIN_TEST_TREE_NODEINDEX
+
+#include "testing.hpp"
+
+#include <parse.hpp>
+#include <lambda.hpp>
+
+namespace Martin {
+    class Test_tree_nodeindex : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(NodeIndex)";
+        }
+
+        bool RunTest() override {
+            std::string code;
+            code += "func apply(let n : Int32) -> Int32 {\n";
+            code += "    let f := lambda (let x : Int32) -> Int32 {\n";
+            code += "        let g := lambda (let y : Int32) -> Int32 { return y * 2 }\n";
+            code += "        return g(x) + 1\n";
+            code += "    }\n";
+            code += "    return f(n)\n";
+            code += "}\n";
+            code += "struct Point { let x : Float32 let y : Float32 }\n";
+            code += "from math import sqrt, pow as power\n";
+
+            Tree tree = ParserSingleton.ParseString(code, error);
+            if (!tree || !tree->GetIndex()) {
+                error = "Parse gave no node index";
+                return false;
+            }
+
+            if (!Compare(tree, "Parsed tree"))
+                return false;
+
+            // Both lambdas get a function appended at the top level
+            ProcessLambdas(tree, "index");
+
+            if (!tree->GetIndex() || (Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::Misc_Func).size() != 3)) {
+                error = "Appending lambdas lost track of the functions";
+                return false;
+            }
+
+            if (!Compare(tree, "Tree with lambdas"))
+                return false;
+
+            // Pieces parsed apart share one index
+            std::string file;
+            while (file.length() < (1 << 17))
+                file += code;
+
+            Tree parallel = ParserSingleton.ParseParallel(TokenizerSingleton.TokenizeString(file), 4);
+            if (!parallel->GetIndex() || !Compare(parallel, "Parallel parse"))
+                return false;
+
+            // Changes the index can't follow drop it
+            tree->erase(tree->begin());
+            if (tree->GetIndex() || !Compare(tree, "Changed tree"))
+                return false;
+
+            return true;
+        }
+
+    private:
+        bool Compare(Tree tree, const std::string& name) {
+            for (size_t type = 0; type < TreeNodeBase::TypeCount; type++) {
+                std::vector<TreeNode> walked;
+
+                Walk(tree, [&](const TokenNode& item) {
+                    if (!item->is_token && (item->node->GetType() == (TreeNodeBase::Type)type))
+                        walked.push_back(item->node);
+
+                    return true;
+                });
+
+                if (Parser::GetAllNodesOfType(tree, (TreeNodeBase::Type)type) != walked) {
+                    error = Format("$ has the wrong nodes of type $ indexed", name, type);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef MARTIN_TEST_TREE_PARALLEL
+#define MARTIN_TEST_TREE_PARALLEL
+
+#include "testing.hpp"
+
+#include <parse.hpp>
+
+namespace Martin {
+    class Test_tree_parallel : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(Parallel)";
+        }
+
+        bool RunTest() override {
+            // Declarations the split can fall between, and ones with modifiers
+            // in front that it must keep together
+            const char* declarations[] = {
+                "func f(let a : Int32) -> Int32 { return (a + 1) ** 2 - ~a & 3 }\n",
+                "class C { public let a : Int32 static func m() { return a } }\n",
+                "struct S { let x : Float32 let y : Float32 }\n",
+                "typedef Int32 T\n",
+                "public func p() { let g := lambda (let y : Int32) -> Int32 { return y } }\n",
+                "extern \"C\" func e(let a : Int32) -> Int32\n",
+                "unsafe func u() { while (a < 3) { a += 1 } if (a) { b } else { c } }\n",
+                "from math import sqrt, pow as power\n"
+            };
+
+            std::string code;
+            for (size_t i = 0; code.length() < (1 << 17); i++)
+                code += declarations[(i * 5) % 8];
+
+            if (!Compare(code, "Declarations"))
+                return false;
+
+            // A negative literal after a name at the top level gets a separator
+            // token inserted, which the pieces can't line up with
+            if (!Compare(code + "func n() { return a -1 }\n" + code, "Separators"))
+                return false;
+
+            return true;
+        }
+
+    private:
+        static std::string Serialize(Tree tree) {
+            std::string serial;
+
+            for (auto node : *tree) {
+                std::string item;
+                node->Serialize(item);
+                serial += item + "; ";
+            }
+
+            return serial;
+        }
+
+        bool Compare(const std::string& code, const std::string& name) {
+            TokenList tokens = TokenizerSingleton.TokenizeString(code);
+            std::string serial = Serialize(ParserSingleton.ParseTokens(tokens));
+
+            for (size_t threads : {2, 3, 8}) {
+                std::string parallel = Serialize(ParserSingleton.ParseParallel(tokens, threads));
+
+                if (parallel != serial) {
+                    error = Format("$ on $ threads parsed differently", name, threads);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
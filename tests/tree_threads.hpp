@@ -0,0 +1,115 @@
+#ifndef MARTIN_TEST_TREE_THREADS
+#define MARTIN_TEST_TREE_THREADS
+
+#include "testing.hpp"
+
+#include <parse.hpp>
+#include <generators/enclosures.hpp>
+#include <generators/expressions.hpp>
+
+#include <thread>
+#include <atomic>
+#include <vector>
+
+namespace Martin {
+    class Test_tree_threads : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(Threads)";
+        }
+
+        bool RunTest() override {
+            const size_t files = 200;
+            const size_t threads = 8;
+
+            // Only brackets and expressions, so a parser of its own gives
+            // different trees than the singleton
+            std::vector<TreeGenerator> generators = {
+                TreeGenerator(new StructEnclosuresTreeGenerator),
+                TreeGenerator(new OPExpressionsTreeGenerator)
+            };
+
+            std::vector<std::string> sources;
+            std::vector<std::string> expected, expected_custom;
+            Parser custom(generators);
+
+            for (size_t file = 0; file < files; file++) {
+                sources.push_back(CreateSource(file));
+                expected.push_back(ParseSerial(ParserSingleton, sources.back()));
+                expected_custom.push_back(ParseSerial(custom, sources.back()));
+
+                if (expected.back().empty() || expected_custom.back().empty()) {
+                    error = Format("Couldn't parse file $", file);
+                    return false;
+                }
+            }
+
+            std::atomic<size_t> next(0);
+            std::atomic<size_t> failed(files);
+            std::vector<std::thread> workers;
+
+            for (size_t t = 0; t < threads; t++) {
+                workers.push_back(std::thread([&, t]() {
+                    // Half the threads share the singleton, the others share
+                    // the custom parser and build one more of their own
+                    Parser own(generators);
+
+                    for (size_t file = next++; file < files; file = next++) {
+                        bool ok;
+                        if (t % 2)
+                            ok = ParseSerial((file % 2) ? own : custom, sources[file]) == expected_custom[file];
+                        else
+                            ok = ParseSerial(ParserSingleton, sources[file]) == expected[file];
+
+                        if (!ok)
+                            failed = file;
+                    }
+                }));
+            }
+
+            for (auto& worker : workers)
+                worker.join();
+
+            if (failed != files) {
+                error = Format("File $ parsed differently on a thread", (size_t)failed);
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        static std::string CreateSource(size_t file) {
+            std::string source;
+
+            for (size_t i = 0; i < 10 + file % 5; i++) {
+                std::string n = std::to_string(file * 100 + i);
+                source += "func f" + n + "(let a : Int32) -> Int32 {\n";
+                source += "    let b := (a + " + n + ") * [a, " + n + " ** 2]\n";
+                source += "    if (b == a and not false) { return b - a }\n";
+                source += "    return a\n";
+                source += "}\n";
+            }
+
+            return source;
+        }
+
+        static std::string ParseSerial(Parser& parser, const std::string& source) {
+            std::string error;
+            Tree tree = parser.ParseString(source, error);
+            if (!tree)
+                return "";
+
+            std::string serial;
+            for (auto node : *tree) {
+                std::string item;
+                node->Serialize(item);
+                serial += item + "; ";
+            }
+
+            return serial;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef MARTIN_TEST_TREE_TREEBASE
+#define MARTIN_TEST_TREE_TREEBASE
+
+#include "testing.hpp"
+
+#include <tree.hpp>
+#include <parse.hpp>
+
+#include <random>
+#include <vector>
+
+namespace Martin {
+    class Test_tree_treebase : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(TreeBase)";
+        }
+
+        bool RunTest() override {
+            std::vector<TokenNode> nodes;
+            for (size_t i = 0; i < 64; i++)
+                nodes.push_back(TokenNode(new TokenNodeBase));
+
+            std::vector<TokenNode> expected;
+            TreeBase tree;
+            std::mt19937 random(16);
+
+            // Same edits on a plain vector and the gap buffer
+            for (size_t step = 0; step < 20000; step++) {
+                size_t index = expected.empty() ? 0 : random() % (expected.size() + 1);
+                TokenNode node = nodes[random() % nodes.size()];
+
+                switch (random() % 5) {
+                    case 0:
+                        expected.push_back(node);
+                        tree.push_back(node);
+                        break;
+
+                    case 1:
+                        expected.insert(expected.begin() + index, node);
+                        tree.insert(tree.begin() + index, node);
+                        break;
+
+                    case 2: {
+                        size_t count = random() % 4;
+                        expected.insert(expected.begin() + index, nodes.begin(), nodes.begin() + count);
+                        tree.insert(tree.begin() + index, nodes.begin(), nodes.begin() + count);
+                        break;
+                    }
+
+                    default: {
+                        if (index >= expected.size())
+                            break;
+
+                        size_t count = 1 + random() % 3;
+                        if (index + count > expected.size())
+                            count = expected.size() - index;
+
+                        expected.erase(expected.begin() + index, expected.begin() + index + count);
+                        tree.erase(tree.begin() + index, tree.begin() + index + count);
+                        break;
+                    }
+                }
+
+                if (tree.size() != expected.size()) {
+                    error = Format("Step $ left $ items, expected $", step, tree.size(), expected.size());
+                    return false;
+                }
+            }
+
+            size_t i = 0;
+            for (auto& node : tree) {
+                if (node != expected[i]) {
+                    error = Format("Item $ doesn't match", i);
+                    return false;
+                }
+                i++;
+            }
+
+            // Erased items shouldn't be kept alive by the gap
+            tree.erase(tree.begin(), tree.end());
+            expected.clear();
+            for (auto& node : nodes) {
+                if (node.use_count() != 1) {
+                    error = "An erased node is still referenced";
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef MARTIN_TEST_TREE_VALIDATION
+#define MARTIN_TEST_TREE_VALIDATION
+
+#include "testing.hpp"
+
+#include <parse.hpp>
+#include <flattree.hpp>
+
+namespace Martin {
+    class Test_tree_validation : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(Validation)";
+        }
+
+        bool RunTest() override {
+            // Arrows need a list of types on the left, the ones on lines 2
+            // and 5 make everything around them invalid
+            std::string code;
+            code += "func f() -> Int32 {\n";
+            code += "    return (Float32 -> Int32)\n";
+            code += "}\n";
+            code += "let h := a + b\n";
+            code += "g((Int32 -> ()))\n";
+
+            TreeNodeBase::ResetValidCounters();
+
+            Tree tree = ParserSingleton.ParseString(code, error);
+            if (!tree || (tree->size() != 3)) {
+                error = "Couldn't parse the code";
+                return false;
+            }
+
+            std::vector<TreeNode> invalid = Parser::FindInvalid(tree);
+            if (!Found(invalid, { 2, 5 }))
+                return false;
+
+            // Every node checked once between the generators and the pass
+            size_t nodes = 0;
+            Walk(tree, [&](const TokenNode& item) {
+                nodes += !item->is_token;
+                return true;
+            });
+
+            if (TreeNodeBase::GetValidCounters().checks > nodes) {
+                error = Format("$ checks for $ nodes", TreeNodeBase::GetValidCounters().checks, nodes);
+                return false;
+            }
+
+            // Everything is known by now
+            TreeNodeBase::ResetValidCounters();
+
+            std::vector<TreeNode> flat = Parser::FindInvalid(FlatTree(new FlatTreeBase(tree)));
+            if (flat != invalid) {
+                error = "Flat tree found different invalid nodes";
+                return false;
+            }
+
+            if (Parser::FindInvalid(tree) != invalid) {
+                error = "Second pass found different invalid nodes";
+                return false;
+            }
+
+            if (!TreeNodeBase::GetValidCounters().calls || TreeNodeBase::GetValidCounters().checks) {
+                error = Format("Passes over a checked tree ran $ checks", TreeNodeBase::GetValidCounters().checks);
+                return false;
+            }
+
+            tree = ParserSingleton.ParseString("func f() -> Int32 {\n    return (a + b) * 2\n}\n", error);
+            if (!tree || !Parser::FindInvalid(tree).empty() || !Parser::Valid(tree)) {
+                error = "Valid code has invalid nodes";
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        bool Found(const std::vector<TreeNode>& invalid, const std::vector<unsigned int>& lines) {
+            if (invalid.size() != lines.size()) {
+                error = Format("Found $ invalid nodes instead of $", invalid.size(), lines.size());
+                return false;
+            }
+
+            for (size_t i = 0; i < lines.size(); i++) {
+                if ((invalid[i]->GetType() != TreeNodeBase::Type::Misc_Arrow) || (invalid[i]->GetLineNumber() != lines[i])) {
+                    error = Format("Found $ on line $ instead of an arrow on line $", invalid[i]->GetName(), invalid[i]->GetLineNumber(), lines[i]);
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef MARTIN_TEST_TREE_WALK
+#define MARTIN_TEST_TREE_WALK
+
+#include "testing.hpp"
+
+#include <parse.hpp>
+
+namespace Martin {
+    class Test_tree_walk : public Test {
+    public:
+        std::string GetName() const override {
+            return "Tree(Walk)";
+        }
+
+        bool RunTest() override {
+            std::string code = "let a := (b + c) * d - e\n";
+            Tree tree = ParserSingleton.ParseString(code, error);
+            if (!tree || (tree->size() != 1)) {
+                error = "Couldn't parse the code";
+                return false;
+            }
+
+            std::string preorder, postorder;
+            Walk(tree, [&](const TokenNode& item) {
+                preorder += Name(item) + " ";
+                return true;
+            });
+
+            Walk(tree, [&](const TokenNode& item) {
+                postorder += Name(item) + " ";
+                return true;
+            }, WalkOrder::Postorder);
+
+            // Let only holds its types, they are missing in "let a :=" and
+            // the walk leaves them out
+            if (preorder != ":= Let - * () + Identifier b Identifier c Identifier d Identifier e ") {
+                error = Format("Walked the tree in preorder as $", preorder);
+                return false;
+            }
+
+            if (postorder != "Let Identifier b Identifier c + () Identifier d * Identifier e - := ") {
+                error = Format("Walked the tree in postorder as $", postorder);
+                return false;
+            }
+
+            // Nothing after the first addition
+            std::string stopped;
+            bool finished = Walk(tree, [&](const TokenNode& item) {
+                stopped += Name(item) + " ";
+                return Name(item) != "+";
+            });
+
+            if (finished || (stopped != ":= Let - * () + ")) {
+                error = Format("Walk stopped after $", stopped);
+                return false;
+            }
+
+            const TreeNode& root = (*tree)[0]->node;
+            auto below = root->GetAllNodesOfType(TreeNodeBase::Type::Struct_Parentheses);
+            auto all = Parser::GetAllNodesOfType(tree, TreeNodeBase::Type::Assignment_TypeAssign);
+
+            if ((below.size() != 1) || (all.size() != 1) || (all[0] != root) || !root->GetAllNodesOfType(TreeNodeBase::Type::Assignment_TypeAssign).empty()) {
+                error = "Nodes of a type found in the wrong places";
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        static std::string Name(const TokenNode& item) {
+            if (item->is_token)
+                return item->token->GetName();
+
+            return item->node->GetName();
+        }
+    };
+}
+
+#endif